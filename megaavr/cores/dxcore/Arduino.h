@@ -39,6 +39,7 @@
  * TCA and TCD only currently */
 #include <avr/pgmspace.h>
 #include <avr/interrupt.h>
+#include "isr_timing.h" // Only does anything when built with CORE_ISR_TIMING
 
 // Currently DxCore has no cases where the millis timer isn't derived from system clock, but that will change
 
@@ -503,6 +504,25 @@ have ports shoulod have those Px constants defined as NOT_A_PORT. I think that w
 // only returned by analogCheckError()
 #define ADC_IMPOSSIBLE_VALUE                        (-127)
 
+// Negative input for a single ended entry in an analogScanStart() table.
+#define ADC_SINGLE_ENDED                            (0xFE)
+// Timers that can pace the background ADC modes (analogSampleStart() and friends). Dx-series only.
+#define ADC_TIMER_TCB0                              (0x00)
+#define ADC_TIMER_TCB1                              (0x01)
+#define ADC_TIMER_TCB2                              (0x02)
+#define ADC_TIMER_TCB3                              (0x03)
+#define ADC_TIMER_TCB4                              (0x04)
+#define ADC_TIMER_RTC                               (0x10)
+// Returned by analogSampleStart() and the other background modes when they can't start.
+#define ADC_SAMPLE_ERROR_BAD_PIN                    (-1) // Not an analog input, or the buffer is too small.
+#define ADC_SAMPLE_ERROR_BUSY                       (-2) // The ADC is already running in one of the background modes.
+#define ADC_SAMPLE_ERROR_TIMER                      (-3) // The timer doesn't exist, is used for millis, or can't produce the requested rate.
+#define ADC_SAMPLE_ERROR_NO_CHANNEL                 (-4) // All the event channels are in use.
+// Crossings that analogWindowStart() calls back for.
+#define ADC_WINDOW_ENTER                            (0x01)
+#define ADC_WINDOW_LEAVE                            (0x02)
+#define ADC_WINDOW_BOTH                             (0x03)
+
 
 #if (!defined(TCB_CLKSEL2_bm))
   // This means it's a tinyAVR 0/1-series, or a megaAVR 0-series.
@@ -672,6 +692,18 @@ void onClockTimeout() __attribute__((weak)); // called if we try to switch to ex
   void attachPortGEnable();
 #endif
 
+// Fast pin interrupts, for a port that only has one pin interrupt. ATTACH_INTERRUPT_FAST(A, 3, onEdge) at file scope
+// defines PORTA_PORT_vect to clear the PA3 flag and call onEdge() directly - no function pointer, no loop over the
+// flags, and if onEdge() can be inlined (it's static, or LTO can see it), only the registers it uses get saved.
+// attachInterruptFast(PIN_PA3, RISING) then turns the interrupt on. See Ref_PinInterrupts.md.
+#define ATTACH_INTERRUPT_FAST(port, bit_pos, handler) \
+  ISR(PORT##port##_PORT_vect) {                       \
+    VPORT##port.INTFLAGS = (1 << (bit_pos));          \
+    handler();                                        \
+  }
+void   attachInterruptFast(uint8_t pin, uint8_t mode);
+void   detachInterruptFast(uint8_t pin);
+
 // ANALOG EXTENDED FUNCTIONS
 // Covered in documentation.
 
@@ -686,6 +718,31 @@ uint8_t      getAnalogReference();
 uint8_t         getDACReference();
 uint8_t getAnalogSampleDuration();
 int8_t  getAnalogReadResolution();
+#if !defined(__AVR_EA__)
+// Background sampling - a timer starts conversions through the event system, and the results are put in a ring buffer.
+int8_t        analogSampleStart(uint8_t pin, int16_t *buffer, uint16_t length, uint16_t rate, uint8_t timer);
+void           analogSampleStop();
+uint16_t  analogSampleAvailable();
+uint16_t       analogSampleRead(int16_t *dest, uint16_t count);
+uint16_t   analogSampleOverruns();
+// Background scan of a list of channels, each with its own settings, into a pair of result frames.
+typedef struct {
+  uint8_t pos;            // Pin or ADC_CH() channel
+  uint8_t neg;            // Pin or ADC_CH() channel for the negative side, or ADC_SINGLE_ENDED
+  uint8_t accumulate;     // 0, or ADC_ACC2 through ADC_ACC128
+  uint8_t sampleDuration; // as for analogSampleDuration()
+} analog_scan_t;
+int8_t          analogScanStart(analog_scan_t *table, uint8_t count, int16_t *results, bool continuous);
+bool          analogScanTrigger();
+const int16_t *analogScanGetFrame();
+void             analogScanStop();
+// Window comparator monitoring - calls back only when a reading crosses into or out of the window.
+int8_t        analogWindowStart(uint8_t pin, int16_t low, int16_t high, uint8_t events, void (*callback)(bool inside, int16_t value), uint16_t rate, uint8_t timer);
+void           analogWindowStop();
+// Used by the background ADC modes to start and stop the timer and event channel that trigger conversions.
+int8_t      _analogTriggerStart(uint8_t timer, uint16_t rate);
+void         _analogTriggerStop();
+#endif
 
 //
 // DIGITAL I/O EXTENDED FUNCTIONS
@@ -733,6 +790,19 @@ extern const uint8_t digital_pin_to_bit_mask[];
 extern const uint8_t digital_pin_to_bit_position[];
 extern const uint8_t digital_pin_to_timer[];
 
+/* Everything digitalWrite(), digitalRead() and pinMode() need to know about a pin, so that they can get it with a single lookup.
+ * The variants generate their digital_pin_to_descriptor[] table from the four above with extras/development/make_pin_descriptors.py */
+typedef struct {
+  uint8_t bit_mask; // NOT_A_PIN if this pin number doesn't exist (or is in use by the clock source)
+  uint8_t pin_ctrl; // Low byte of the address of PINnCTRL. The PORT struct is at 0x400 + (pin_ctrl & 0xE0), and the VPORT number is pin_ctrl >> 5.
+  uint8_t pwm;      // The timer table entry, with TIMERA0 added for bits 0-5, which a type A timer can be pointed at. If 0, no PWM can be on this pin.
+} pin_descriptor_t;
+extern const pin_descriptor_t digital_pin_to_descriptor[];
+#define _PIN_DESC(port, bit_pos, timer)     {(1 << (bit_pos)), (0x10 + ((port) << 5) + (bit_pos)), ((timer) | ((bit_pos) < 6 ? TIMERA0 : NOT_ON_TIMER))}
+#define _PIN_DESC_NONE                      {NOT_A_PIN, 0, NOT_ON_TIMER}
+#define _pinDescToPortStruct(desc)          ((PORT_t *)           (0x0400 | ((desc)->pin_ctrl & 0xE0)))
+#define _pinDescToPINnCTRL(desc)            ((volatile uint8_t *) (0x0400 |  (desc)->pin_ctrl))
+
 /*
 Supplied by Variant file:
 #define digitalPinToAnalogInput(p)      // Given digital pin (p), returns the analog channel number, or NOT_A_PIN if the pin does not suipport analog input.
@@ -1084,6 +1154,187 @@ void pinConfigure(const uint8_t digital_pin, const pin_configure_t mode, const M
  * and makes it look like an API instead of something knocked together by a C programmer.
  */
 
+/* Pin groups - a set of pins, fixed at compile time, that you write a value to or read a value from as a unit.
+ * PinGroup<PIN_PA2, PIN_PA3, PIN_PC0, PIN_PD1> bus; bus.write(0b1010); - bit 0 of the value goes to the first pin listed, and so on.
+ * Everything about the pins is worked out by the compiler, so all that's left at runtime is moving the bits into
+ * place (a shift if the pins on a port are in order, a couple of instructions per pin if they aren't) and one or two
+ * writes per port: one write to VPORTx.OUT if the group includes the whole port, otherwise OUTSET and OUTCLR.
+ * Pins on different ports change a few clocks apart, ports in alphabetical order; read() likewise reads each port once.
+ * Only valid for the standard pin numbering (the pin number must be convertible to port and bit without the tables). */
+template <bool C, typename T, typename F> struct _pin_group_cond                 { typedef T type; };
+template <typename T, typename F>         struct _pin_group_cond<false, T, F>    { typedef F type; };
+template <uint8_t... I>                   struct _pin_group_seq                  { };
+template <uint8_t N, uint8_t... I>        struct _pin_group_make_seq : _pin_group_make_seq<N - 1, N - 1, I...> { };
+template <uint8_t... I>                   struct _pin_group_make_seq<0, I...>    { typedef _pin_group_seq<I...> type; };
+
+template <uint8_t... PINS>
+constexpr bool _pin_group_valid() {
+  return ((_digitalPinToCanon(PINS) != NOT_A_PIN) && ...);
+}
+
+template <uint8_t... PINS>
+class PinGroup {
+  static_assert(sizeof...(PINS) > 0 && sizeof...(PINS) <= 32, "A PinGroup must have between 1 and 32 pins");
+  static_assert(_pin_group_valid<PINS...>(), "Every pin in a PinGroup must be a valid pin number, known at compile time");
+ public:
+  typedef typename _pin_group_cond<(sizeof...(PINS) <= 8), uint8_t,
+          typename _pin_group_cond<(sizeof...(PINS) <= 16), uint16_t, uint32_t>::type>::type value_t;
+
+ private:
+  typedef typename _pin_group_make_seq<sizeof...(PINS)>::type _indices;
+  static constexpr uint8_t _NOT_IN_ORDER = 0x7F;
+
+  /* port * 8 + bit position of the i'th pin */
+  static constexpr uint8_t _canon(uint8_t i) {
+    const uint8_t canon[] = {(uint8_t) _digitalPinToCanon(PINS)...};
+    return canon[i];
+  }
+  /* The pins in the group on this port */
+  static constexpr uint8_t _portMask(uint8_t port) {
+    uint8_t mask = 0;
+    for (uint8_t i = 0; i < sizeof...(PINS); i++) {
+      if ((_canon(i) >> 3) == port) {
+        mask |= 1 << (_canon(i) & 7);
+      }
+    }
+    return mask;
+  }
+  /* The bits of the value that go to this port */
+  static constexpr value_t _valueMask(uint8_t port) {
+    value_t mask = 0;
+    for (uint8_t i = 0; i < sizeof...(PINS); i++) {
+      if ((_canon(i) >> 3) == port) {
+        mask |= ((value_t) 1) << i;
+      }
+    }
+    return mask;
+  }
+  /* If every pin on this port is the same distance from its bit in the value, that distance (bit position - index),
+   * so the value can just be shifted into place. Otherwise _NOT_IN_ORDER. */
+  static constexpr int8_t _portShift(uint8_t port) {
+    int8_t shift = _NOT_IN_ORDER;
+    for (uint8_t i = 0; i < sizeof...(PINS); i++) {
+      if ((_canon(i) >> 3) == port) {
+        int8_t d = (int8_t)(_canon(i) & 7) - (int8_t) i;
+        if (shift == _NOT_IN_ORDER) {
+          shift = d;
+        } else if (shift != d) {
+          return _NOT_IN_ORDER;
+        }
+      }
+    }
+    return shift;
+  }
+
+  template <uint8_t PORT, uint8_t... I>
+  static inline __attribute__((always_inline)) uint8_t _scatter(value_t value, _pin_group_seq<I...>) {
+    constexpr int8_t shift = _portShift(PORT);
+    if constexpr (shift == _NOT_IN_ORDER) {
+      return (0 | ... | (((_canon(I) >> 3) == PORT && (value & (((value_t) 1) << I))) ? (uint8_t)(1 << (_canon(I) & 7)) : 0));
+    } else if constexpr (shift >= 0) {
+      return (uint8_t)((value & _valueMask(PORT)) << shift);
+    } else {
+      return (uint8_t)((value & _valueMask(PORT)) >> -shift);
+    }
+  }
+  template <uint8_t PORT, uint8_t... I>
+  static inline __attribute__((always_inline)) value_t _gather(uint8_t in, _pin_group_seq<I...>) {
+    constexpr int8_t shift = _portShift(PORT);
+    if constexpr (shift == _NOT_IN_ORDER) {
+      return (0 | ... | (((_canon(I) >> 3) == PORT && (in & (1 << (_canon(I) & 7)))) ? (((value_t) 1) << I) : 0));
+    } else if constexpr (shift >= 0) {
+      return (value_t)(in & _portMask(PORT)) >> shift;
+    } else {
+      return ((value_t)(in & _portMask(PORT))) << -shift;
+    }
+  }
+
+  template <uint8_t PORT>
+  static inline __attribute__((always_inline)) void _writePort(value_t value) {
+    constexpr uint8_t mask = _portMask(PORT);
+    if constexpr (mask == 0xFF) {
+      ((VPORT_t *)(PORT * 4))->OUT = _scatter<PORT>(value, _indices());
+    } else if constexpr (mask) {
+      uint8_t bits = _scatter<PORT>(value, _indices());
+      ((PORT_t *)(0x0400 + PORT * 0x20))->OUTSET = bits;
+      ((PORT_t *)(0x0400 + PORT * 0x20))->OUTCLR = bits ^ mask;
+    }
+  }
+  template <uint8_t PORT>
+  static inline __attribute__((always_inline)) void _togglePort(value_t value) {
+    if constexpr (_portMask(PORT)) {
+      ((VPORT_t *)(PORT * 4))->IN = _scatter<PORT>(value, _indices()); // writing 1 to VPORTx.IN toggles the pin
+    }
+  }
+  template <uint8_t PORT>
+  static inline __attribute__((always_inline)) value_t _readPort() {
+    if constexpr (_portMask(PORT)) {
+      return _gather<PORT>(((VPORT_t *)(PORT * 4))->IN, _indices());
+    } else {
+      return 0;
+    }
+  }
+  template <uint8_t PORT>
+  static inline __attribute__((always_inline)) void _modePort(uint8_t pin_mode) {
+    constexpr uint8_t mask = _portMask(PORT);
+    if constexpr (mask) {
+      PORT_t *port = (PORT_t *)(0x0400 + PORT * 0x20);
+      if (pin_mode == OUTPUT) {
+        port->DIRSET = mask;
+      } else {
+        volatile uint8_t *pin_ctrl = &port->PIN0CTRL;
+        uint8_t status = SREG;          // PINnCTRL is read-modify-write, like in pinMode(),
+        cli();                          // so an ISR touching the same port can't be undone.
+        port->DIRCLR = mask;
+        for (uint8_t bit = 0; bit < 8; bit++) {
+          if (mask & (1 << bit)) {
+            if (pin_mode == INPUT_PULLUP) {
+              pin_ctrl[bit] |= PORT_PULLUPEN_bm;
+            } else {
+              pin_ctrl[bit] &= ~PORT_PULLUPEN_bm;
+            }
+          }
+        }
+        SREG = status;
+      }
+    }
+  }
+
+ public:
+  /* Bit n of value goes to the n'th pin in the list. */
+  static inline __attribute__((always_inline)) void write(value_t value) {
+    _writePort<0>(value); _writePort<1>(value); _writePort<2>(value); _writePort<3>(value);
+    _writePort<4>(value); _writePort<5>(value); _writePort<6>(value);
+  }
+  /* Toggle the pins for which bits are set in value. */
+  static inline __attribute__((always_inline)) void toggle(value_t value) {
+    _togglePort<0>(value); _togglePort<1>(value); _togglePort<2>(value); _togglePort<3>(value);
+    _togglePort<4>(value); _togglePort<5>(value); _togglePort<6>(value);
+  }
+  /* Bit n of the result is the state of the n'th pin in the list. */
+  static inline __attribute__((always_inline)) value_t read() {
+    return _readPort<0>() | _readPort<1>() | _readPort<2>() | _readPort<3>() | _readPort<4>() | _readPort<5>() | _readPort<6>();
+  }
+  /* OUTPUT, INPUT or INPUT_PULLUP for all the pins. Unlike pinMode(), this does not turn off PWM. */
+  static inline __attribute__((always_inline)) void mode(uint8_t pin_mode) {
+    _modePort<0>(pin_mode); _modePort<1>(pin_mode); _modePort<2>(pin_mode); _modePort<3>(pin_mode);
+    _modePort<4>(pin_mode); _modePort<5>(pin_mode); _modePort<6>(pin_mode);
+  }
+  static constexpr uint8_t size() {
+    return sizeof...(PINS);
+  }
+};
+
+/* Function style access, for those who prefer it: digitalWriteGroup(bus, value), readGroup(bus) */
+template <uint8_t... PINS>
+inline __attribute__((always_inline)) void digitalWriteGroup(const PinGroup<PINS...> &, typename PinGroup<PINS...>::value_t value) {
+  PinGroup<PINS...>::write(value);
+}
+template <uint8_t... PINS>
+inline __attribute__((always_inline)) typename PinGroup<PINS...>::value_t readGroup(const PinGroup<PINS...> &) {
+  return PinGroup<PINS...>::read();
+}
+
 #endif
 
 #include "pinswap.h"
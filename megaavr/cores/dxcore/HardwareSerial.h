@@ -47,8 +47,7 @@
  * was missing optimizations, and there's no particular reason to have
  * a weird sized buffer, and several reasons not to.
  *
- * More than 256b buffers imposes a considerable performance penalty,
- * - one large enough to obliviate the entire purpose, because of the
+ * More than 256b buffers imposes a performance penalty, because of the
  * need to make the access to the current index atomic. This atomic
  * block is costly - it's a macro for cli and sei
  * implemented in inline assembly, which sounds fast. But the optimizer
@@ -56,8 +55,13 @@
  *  ": memory" clobber to create a memory barrier. This ensures that it
  * is atomic, but significantly hurts performance. (theoretical worst case
  * is 94 clocks, real-world is usually far less, but I'll only say "less"
- * The functions in question have considerable register pressure). But,
- * it unquestionably would impact USART performance at high speeds.
+ * The functions in question have considerable register pressure).
+ * The ISRs don't need that (nothing can interrupt them except a level 1
+ * interrupt, and those had better not be using serial), and the ASM ISRs
+ * handle 16-bit indices for buffers of 512, 1024 and 2048 bytes at a cost
+ * of only a few clocks, so if you have the RAM, on the sending/receiving end
+ * where the ISRs are all that matters at high baud rates, it's worth it.
+ * See the table in Ref_Serial.md for clock counts.
  *
  * * The USE_ASM_* options can be disabled by defining them as 0 either in variant pins_arduino.h
  * The buffer sizes can be overridden in by defining SERIAL_TX_BUFFER either in variant file (
@@ -151,6 +155,18 @@
 #if (SERIAL_RX_BUFFER_SIZE & (SERIAL_RX_BUFFER_SIZE - 1))
   #error "ERROR: RX buffer size must be a power of two."
 #endif
+/* The ASM ISRs handle any power of two size from 16 to 2048 - 8-bit indices up to 256, and 16-bit ones beyond that.
+ * Any larger and the buffer won't fit on any part with the RAM to spare anyway. */
+#if (SERIAL_RX_BUFFER_SIZE >= 16 && SERIAL_RX_BUFFER_SIZE <= 2048)
+  #define SERIAL_RX_BUFFER_ASM_OK 1
+#else
+  #define SERIAL_RX_BUFFER_ASM_OK 0
+#endif
+#if (SERIAL_TX_BUFFER_SIZE >= 16 && SERIAL_TX_BUFFER_SIZE <= 2048)
+  #define SERIAL_TX_BUFFER_ASM_OK 1
+#else
+  #define SERIAL_TX_BUFFER_ASM_OK 0
+#endif
 
 /* Buffer sizing done */
 /* DANGER DANGER DANGER */
@@ -194,13 +210,12 @@
 // 301 for 2-series, which may be nearly 9% of the total flash!
 // The USE_ASM_* options can be disabled by defining them as 0 (in the same way that buffer sizes can be overridden)
 
-#if USE_ASM_RXC == 1 && !(SERIAL_RX_BUFFER_SIZE == 256 || SERIAL_RX_BUFFER_SIZE == 128 || SERIAL_RX_BUFFER_SIZE == 64 || SERIAL_RX_BUFFER_SIZE == 32 || SERIAL_RX_BUFFER_SIZE == 16)
-  #error "Assembly RX Complete (RXC) ISR is only supported when RX buffer size are 256, 128, 64, 32 or 16 bytes"
+#if USE_ASM_RXC == 1 && !SERIAL_RX_BUFFER_ASM_OK
+  #error "Assembly RX Complete (RXC) ISR is only supported when RX buffer size is 2048, 1024, 512, 256, 128, 64, 32 or 16 bytes"
 #endif
 
-#if USE_ASM_DRE == 1 && !((SERIAL_RX_BUFFER_SIZE == 256 || SERIAL_RX_BUFFER_SIZE == 128 || SERIAL_RX_BUFFER_SIZE == 64 || SERIAL_RX_BUFFER_SIZE == 32 || SERIAL_RX_BUFFER_SIZE == 16) && \
-                          (SERIAL_TX_BUFFER_SIZE == 256 || SERIAL_TX_BUFFER_SIZE == 128 || SERIAL_TX_BUFFER_SIZE == 64 || SERIAL_TX_BUFFER_SIZE == 32 || SERIAL_TX_BUFFER_SIZE == 16))
-  #error "Assembly Data Register Empty (DRE) ISR is only supported when both TX and RX buffer sizes are 256, 128, 64, 32 or 16 bytes"
+#if USE_ASM_DRE == 1 && !(SERIAL_RX_BUFFER_ASM_OK && SERIAL_TX_BUFFER_ASM_OK)
+  #error "Assembly Data Register Empty (DRE) ISR is only supported when both TX and RX buffer sizes are 2048, 1024, 512, 256, 128, 64, 32 or 16 bytes"
 #endif
 
 
@@ -233,6 +248,10 @@ class HardwareSerial : public Stream {
     volatile rx_buffer_index_t _rx_buffer_tail;
     volatile tx_buffer_index_t _tx_buffer_head;
     volatile tx_buffer_index_t _tx_buffer_tail;
+    volatile uint8_t _frame_mode;         // bit 0 = end frames on _frame_delim, bit 1 = end frames on idle (_frame_tcb), bit 7 = a frame has ended
+    uint8_t _frame_delim;                 // frame delimiter character
+    uint8_t _frame_tcb;                   // low byte of the address of the TCB timing the idle gap. High byte is always 0x0B.
+    volatile rx_buffer_index_t _frame_end; // head index just after the end of the last complete frame
     // Don't put any members after these buffers, since only the first
     // 32 bytes of this struct can be accessed quickly using the ldd
     // instruction.
@@ -307,16 +326,31 @@ class HardwareSerial : public Stream {
     virtual int available(void);
     virtual      int peek(void);
     virtual      int read(void);
+    size_t               read(uint8_t *buffer, size_t length);      // copy out whatever is already buffered, up to length bytes. Never waits.
+    size_t          readBytes(char *buffer, size_t length);         // Like Stream::readBytes(), but copies buffered data in bulk.
+    size_t          readBytes(uint8_t *buffer, size_t length)   {return readBytes((char *) buffer, length);}
     virtual    void flush(void);
     virtual  size_t write(uint8_t ch);
+    virtual  size_t write(const uint8_t *buffer, size_t size); // block write - one copy into the ring per chunk instead of write(uint8_t) per byte.
     inline   size_t write(unsigned long n)  {return write((uint8_t)n);}
     inline   size_t write(long n)           {return write((uint8_t)n);}
     inline   size_t write(unsigned int n)   {return write((uint8_t)n);}
     inline   size_t write(int n)            {return write((uint8_t)n);}
-    using Print::write; // pull in write(str) and write(buf, size) from Print
+    using Print::write; // pull in write(str) and write(char*, size) from Print - write(uint8_t*, size) is overridden above.
     explicit operator bool() {
       return true;
     }
+    // Zero-copy access to the ring buffers - see Ref_Serial.md
+    size_t                readSpan(const uint8_t **data);                                                      // contiguous received bytes at *data
+    size_t               readSpans(const uint8_t **first, size_t *firstLength, const uint8_t **second);      // both halves; returns total
+    void                   consume(size_t count);                                                            // discard count bytes once parsed
+    size_t               writeSpan(uint8_t **data);                                                          // contiguous free space at *data
+    void                    commit(size_t count);                                                            // send count bytes written there
+    // Frame detection - see Ref_Serial.md
+    void       setFrameDelimiter(uint8_t delimiter);                 // a frame ends after each delimiter character received
+    bool         setFrameTimeout(TCB_t &timer, uint16_t bitTimes);   // a frame ends when the line has been idle for bitTimes. Call after begin()
+    void             stopFraming();
+    int           frameAvailable();                                   // length of the complete frame(s) waiting in the buffer, or 0
     uint8_t autoBaudWFB();
     void simpleSync();
     uint8_t autobaudWFB_and_wait(uint8_t n);
@@ -340,13 +374,10 @@ class HardwareSerial : public Stream {
     uint8_t getPin(uint8_t pin); //wrapper around static _getPin
 
     // Interrupt handlers - Not intended to be called externally
-    #if !(USE_ASM_RXC == 1 && \
-         (SERIAL_RX_BUFFER_SIZE == 256 || SERIAL_RX_BUFFER_SIZE == 128 || SERIAL_RX_BUFFER_SIZE == 64 || SERIAL_RX_BUFFER_SIZE == 32 || SERIAL_RX_BUFFER_SIZE == 16))
+    #if !(USE_ASM_RXC == 1 && SERIAL_RX_BUFFER_ASM_OK)
       static void _rx_complete_irq(HardwareSerial& uartClass);
     #endif
-    #if !(USE_ASM_DRE == 1 && \
-         (SERIAL_RX_BUFFER_SIZE == 256 || SERIAL_RX_BUFFER_SIZE == 128 || SERIAL_RX_BUFFER_SIZE == 64 || SERIAL_RX_BUFFER_SIZE == 32 || SERIAL_RX_BUFFER_SIZE == 16) && \
-         (SERIAL_TX_BUFFER_SIZE == 256 || SERIAL_TX_BUFFER_SIZE == 128 || SERIAL_TX_BUFFER_SIZE == 64 || SERIAL_TX_BUFFER_SIZE == 32 || SERIAL_TX_BUFFER_SIZE == 16))
+    #if !(USE_ASM_DRE == 1 && SERIAL_RX_BUFFER_ASM_OK && SERIAL_TX_BUFFER_ASM_OK)
       static void _tx_data_empty_irq(HardwareSerial& uartClass);
     #endif
 
@@ -34,6 +34,62 @@
     #else
       #define TX_BUFFER_ATOMIC
     #endif
+    #if (SERIAL_RX_BUFFER_SIZE > 256)
+      #define RX_BUFFER_ATOMIC ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    #else
+      #define RX_BUFFER_ATOMIC
+    #endif
+
+    /* Offsets from the start of a HardwareSerial object of the members that the ASM ISRs use. These MUST match the
+     * member layout in HardwareSerial.h. The vtable pointer takes bytes 0-1, Print::write_error 2-3, and Stream::_timeout
+     * 4-7, so _hwserial_module is at 8, and _state at 14. After that come the four indices, which are 1 byte each for
+     * buffers of 256b or less, and 2 bytes for larger buffers, then the three framing bytes (mode, delimiter, timer),
+     * _frame_end (sized like the RX indices), and then the two buffers.
+     * They're spelled out instead of added up because they get pasted into ldd/std displacements. The high byte of 16-bit
+     * indices gets its own define (_OFSH) for the same reason.
+     */
+    #if   (SERIAL_RX_BUFFER_SIZE <= 256) && (SERIAL_TX_BUFFER_SIZE <= 256)
+      #define _SER_TXHEAD_OFS 17
+      #define _SER_TXTAIL_OFS 18
+      #define _SER_FRMODE_OFS 19
+      #define _SER_FRDELIM_OFS 20
+      #define _SER_FRTCB_OFS  21
+      #define _SER_FREND_OFS  22
+      #define _SER_RXBUF_OFS  23
+    #elif (SERIAL_RX_BUFFER_SIZE  > 256) && (SERIAL_TX_BUFFER_SIZE <= 256)
+      #define _SER_TXHEAD_OFS 19
+      #define _SER_TXTAIL_OFS 20
+      #define _SER_FRMODE_OFS 21
+      #define _SER_FRDELIM_OFS 22
+      #define _SER_FRTCB_OFS  23
+      #define _SER_FREND_OFS  24
+      #define _SER_FREND_OFSH 25
+      #define _SER_RXBUF_OFS  26
+    #elif (SERIAL_RX_BUFFER_SIZE <= 256) && (SERIAL_TX_BUFFER_SIZE  > 256)
+      #define _SER_TXHEAD_OFS 17
+      #define _SER_TXHEAD_OFSH 18
+      #define _SER_TXTAIL_OFS 19
+      #define _SER_TXTAIL_OFSH 20
+      #define _SER_FRMODE_OFS 21
+      #define _SER_FRDELIM_OFS 22
+      #define _SER_FRTCB_OFS  23
+      #define _SER_FREND_OFS  24
+      #define _SER_RXBUF_OFS  25
+    #else
+      #define _SER_TXHEAD_OFS 19
+      #define _SER_TXHEAD_OFSH 20
+      #define _SER_TXTAIL_OFS 21
+      #define _SER_TXTAIL_OFSH 22
+      #define _SER_FRMODE_OFS 23
+      #define _SER_FRDELIM_OFS 24
+      #define _SER_FRTCB_OFS  25
+      #define _SER_FREND_OFS  26
+      #define _SER_FREND_OFSH 27
+      #define _SER_RXBUF_OFS  28
+    #endif
+    // _rx_buffer_head is always at 15, and _rx_buffer_tail at 16 (8-bit) or 17 (16-bit). _tx_buffer is right after _rx_buffer.
+    #define _SER_XSTR(x) #x
+    #define _SER_STR(x) _SER_XSTR(x)
 
     /*##  ###  ####
       #  #     #   #
@@ -171,6 +227,7 @@
     */
 
     #if ((USE_ASM_RXC == 1) && (SERIAL_RX_BUFFER_SIZE == 256 || SERIAL_RX_BUFFER_SIZE == 128 || SERIAL_RX_BUFFER_SIZE == 64 || SERIAL_RX_BUFFER_SIZE == 32 || SERIAL_RX_BUFFER_SIZE == 16) )
+      // 8-bit indices.
       void __attribute__((naked)) __attribute__((used)) __attribute__((noreturn)) _do_rxc(void) {
         __asm__ __volatile__(
           "_do_rxc:"                      "\n\t" // We start out 11-13 clocks after the interrupt
@@ -229,9 +286,12 @@
             "add        r28,       r30"   "\n\t" // r28 has what would be the next index in it.
             "mov        r29,       r31"   "\n\t" // and this is the high byte of serial instance
             "ldi        r18,         0"   "\n\t" // need a known zero to carry.
-            "adc        r29,       r18"   "\n\t" // carry - Y is now pointing 19 bytes before head
-            "std     Y + 19,       r25"   "\n\t" // store the new char in buffer
+            "adc        r29,       r18"   "\n\t" // carry - Y is now pointing _SER_RXBUF_OFS bytes before head
+            "std     Y + " _SER_STR(_SER_RXBUF_OFS) ", r25" "\n\t" // store the new char in buffer
             "std     Z + 15,       r24"   "\n\t" // write that new head index.
+            "ldd        r28,    Z + " _SER_STR(_SER_FRMODE_OFS) "\n\t" // framing enabled? 4 clocks if not.
+            "tst        r28"              "\n\t"
+            "brne  _rxc_frame"            "\n\t"
           "_end_rxc:"                     "\n\t"
             "std     Z + 14,       r19"   "\n\t" // record new state including new errors
                                        // Epilogue: 9 pops + 1 out + 1 reti +1 std = 24 clocks
@@ -245,14 +305,176 @@
             "pop        r18"              "\n\t" // used as tail offset, and then as known zero.
             "pop        r31"              "\n\t" // end with Z which the isr pushed to make room for
             "pop        r30"              "\n\t" // pointer to serial instance
+            ISR_TIMING_EXIT_ASM                  // nothing unless built with CORE_ISR_TIMING
             "reti"                        "\n\t" // return
           "_buff_full_rxc:"               "\n\t" // _buff_full_rxc moved to after the reti, and then rjmps back, saving 2 clocks for the common case
             "ori        r19,      0x40"   "\n\t" // record that there was a ring buffer overflow. 1 clk
             "rjmp _end_rxc"               "\n\t" // and now jump back to end. That way we don't need to jump over this in the middle of the common case.
-            ::); // total: 77 or 79 clocks, just barely squeaks by for cyclic RX of up to RX_BUFFER_SIZE characters.
+          "_rxc_frame:"                   "\n\t" // Framing is on - r28 = _frame_mode, r24 = new head, r25 = the character, r18 and Y are free.
+            "sbrs       r28,         1"   "\n\t" // idle timeout enabled?
+            "rjmp  _rxc_frame_delim"      "\n\t" // if not skip to the delimiter check
+            "ldd        r28,    Z + " _SER_STR(_SER_FRTCB_OFS) "\n\t" // Y = the TCB timing the idle gap
+            "ldi        r29,      0x0B"   "\n\t" // all TCBs are 0x0Bn0
+            "ldd        r18,    Y +  6"   "\n\t" // Y + 6 = TCBn.INTFLAGS
+            "sbrs       r18,         0"   "\n\t" // if CAPT is set, the line went idle before this character arrived
+            "rjmp  _rxc_frame_restart"    "\n\t"
+            "std      Y + 6,       r18"   "\n\t" // clear the flags
+            "mov        r18,       r24"   "\n\t" // the frame ended just before this character - that's the old head
+            "subi       r18,         1"   "\n\t"
+    #if   SERIAL_RX_BUFFER_SIZE == 128
+            "andi       r18,      0x7F"   "\n\t"
+    #elif SERIAL_RX_BUFFER_SIZE == 64
+            "andi       r18,      0x3F"   "\n\t"
+    #elif SERIAL_RX_BUFFER_SIZE == 32
+            "andi       r18,      0x1F"   "\n\t"
+    #elif SERIAL_RX_BUFFER_SIZE == 16
+            "andi       r18,      0x0F"   "\n\t"
+    #endif
+            "std     Z + " _SER_STR(_SER_FREND_OFS) ", r18" "\n\t"
+            "ldd        r18,    Z + " _SER_STR(_SER_FRMODE_OFS) "\n\t"
+            "ori        r18,      0x80"   "\n\t" // flag that a frame has ended
+            "std     Z + " _SER_STR(_SER_FRMODE_OFS) ", r18" "\n\t"
+          "_rxc_frame_restart:"           "\n\t"
+            "ldi        r18,         0"   "\n\t" // restart the idle timer
+            "std     Y + 10,       r18"   "\n\t" // Y + 10 = TCBn.CNTL - goes to TEMP
+            "std     Y + 11,       r18"   "\n\t" // Y + 11 = TCBn.CNTH - writes both
+          "_rxc_frame_delim:"             "\n\t"
+            "ldd        r18,    Z + " _SER_STR(_SER_FRMODE_OFS) "\n\t"
+            "sbrs       r18,         0"   "\n\t" // delimiter enabled?
+            "rjmp  _end_rxc"              "\n\t"
+            "ldd        r28,    Z + " _SER_STR(_SER_FRDELIM_OFS) "\n\t"
+            "cpse       r28,       r25"   "\n\t" // is this the delimiter?
+            "rjmp  _end_rxc"              "\n\t"
+            "ori        r18,      0x80"   "\n\t" // if so, the frame ends with it, at the new head
+            "std     Z + " _SER_STR(_SER_FRMODE_OFS) ", r18" "\n\t"
+            "std     Z + " _SER_STR(_SER_FREND_OFS) ", r24" "\n\t"
+            "rjmp  _end_rxc"              "\n\t"
+            ::); // total: 81, or 79 if buffer full, with framing off. Just barely squeaks by for cyclic RX of up to RX_BUFFER_SIZE characters.
         __builtin_unreachable();
 
       }
+    #elif ((USE_ASM_RXC == 1) && SERIAL_RX_BUFFER_ASM_OK)
+      /* 16-bit indices, for 512, 1024 and 2048 byte buffers.
+       * We're one register short compared to the 8-bit version, and rather than push another pair, we use a trick: The slot
+       * at the head index is never read by anything (the ring always keeps one slot empty; readers stop at head), so we can
+       * store the character there *before* checking whether the buffer is full, after which Y is free to hold the tail. If
+       * it turns out to be full, we just don't advance the head, and the character we wrote is never seen. 5 clocks more
+       * than the 8-bit version.
+       */
+      void __attribute__((naked)) __attribute__((used)) __attribute__((noreturn)) _do_rxc(void) {
+        __asm__ __volatile__(
+          "_do_rxc:"                      "\n\t" // We start out 11-13 clocks after the interrupt
+            "push       r18"              "\n\t" // r30 and r31 pushed before this.
+            "in         r18,      0x3f"   "\n\t" // Save SREG
+            "push       r18"              "\n\t" //
+            "push       r19"              "\n\t" //
+            "push       r24"              "\n\t" //
+            "push       r25"              "\n\t" //
+            "push       r28"              "\n\t" //
+            "push       r29"              "\n\t" //
+            "ldd        r28,    Z +  8"   "\n\t" // Load USART into Y pointer
+            "ldi        r29,      0x08"   "\n\t" // High byte always 0x08 for USART peripheral
+  #if defined(ERRATA_USART_WAKE)
+            "ldd        r18,    Y +  6"   "\n\t"
+            "andi       r18,      0xEF"   "\n\t"
+            "std      Y + 6,       r18"   "\n\t" // turn off SFD interrupt before reading RXDATA so we don't corrupt the next character.
+  #endif
+            "ldd        r24,    Y +  1"   "\n\t" // Y + 1 = USARTn.RXDATAH - load high byte first
+            "ld         r18,         Y"   "\n\t" // Y + 0 = USARTn.RXDATAL - character goes in r18 this time, we need r24:r25 as a pair
+            "andi       r24,      0x46"   "\n\t" // extract framing, parity bits.
+            "lsl        r24"              "\n\t" // leftshift them one place
+            "ldd        r19,    Z + 14"   "\n\t" // load _state
+            "or         r19,       r24"   "\n\t" // bitwise or with errors extracted from _state
+            "sbrc       r24,         2"   "\n\t" // if there's a parity error, then do nothing more (note the leftshift).
+            "rjmp  _end_rxc"              "\n\t"
+            "ldd        r24,    Z + 15"   "\n\t" // load current head index, low byte
+            "ldd        r25,    Z + 16"   "\n\t" // and high byte
+            "movw       r28,       r30"   "\n\t" // Y = this
+            "add        r28,       r24"   "\n\t" // plus head
+            "adc        r29,       r25"   "\n\t" // Y is now pointing _SER_RXBUF_OFS bytes before head
+            "std     Y + " _SER_STR(_SER_RXBUF_OFS) ", r18" "\n\t" // store the char in the free slot - harmless if the buffer is full, see above
+            "adiw       r24,         1"   "\n\t" // increment head
+    #if   SERIAL_RX_BUFFER_SIZE == 2048
+            "andi       r25,      0x07"   "\n\t" // Wrap the head around - low byte wraps naturally
+    #elif SERIAL_RX_BUFFER_SIZE == 1024
+            "andi       r25,      0x03"   "\n\t" // Wrap the head around
+    #elif SERIAL_RX_BUFFER_SIZE == 512
+            "andi       r25,      0x01"   "\n\t" // Wrap the head around
+    #endif
+            "ldd        r28,    Z + 17"   "\n\t" // load tail index low byte - Y is free now
+            "ldd        r29,    Z + 18"   "\n\t" // and high byte
+            "cp         r28,       r24"   "\n\t" // See if new head is at tail. If so, buffer full, and we leave without
+            "cpc        r29,       r25"   "\n\t" // advancing the head, so the character is discarded.
+            "breq  _buff_full_rxc"        "\n\t"
+            "std     Z + 15,       r24"   "\n\t" // write the new head index. Nothing can interrupt us
+            "std     Z + 16,       r25"   "\n\t" // between these, and the readers read it atomically.
+            "ldd        r28,    Z + " _SER_STR(_SER_FRMODE_OFS) "\n\t" // framing enabled? 4 clocks if not.
+            "tst        r28"              "\n\t"
+            "brne  _rxc_frame"            "\n\t"
+          "_end_rxc:"                     "\n\t"
+            "std     Z + 14,       r19"   "\n\t" // record new state including new errors
+            "pop        r29"              "\n\t" // Y Pointer was used for the USART, head and tail.
+            "pop        r28"              "\n\t" //
+            "pop        r25"              "\n\t" // r24:r25 held rxdatah then the new head.
+            "pop        r24"              "\n\t" //
+            "pop        r19"              "\n\t" // restore r19 which held the value that State will have after this.
+            "pop        r18"              "\n\t" // Restore saved SREG
+            "out       0x3f,       r18"   "\n\t" // and write back
+            "pop        r18"              "\n\t" // used for the character
+            "pop        r31"              "\n\t" // end with Z which the isr pushed to make room for
+            "pop        r30"              "\n\t" // pointer to serial instance
+            ISR_TIMING_EXIT_ASM                  // nothing unless built with CORE_ISR_TIMING
+            "reti"                        "\n\t" // return
+          "_buff_full_rxc:"               "\n\t"
+            "ori        r19,      0x40"   "\n\t" // record that there was a ring buffer overflow.
+            "rjmp _end_rxc"               "\n\t"
+          "_rxc_frame:"                   "\n\t" // Framing is on - r28 = _frame_mode, r24:r25 = new head, r18 = the character.
+            "push       r26"              "\n\t" // We're out of registers here, but this is off the common path.
+            "push       r27"              "\n\t"
+            "sbrs       r28,         1"   "\n\t" // idle timeout enabled?
+            "rjmp  _rxc_frame_delim"      "\n\t"
+            "ldd        r28,    Z + " _SER_STR(_SER_FRTCB_OFS) "\n\t" // Y = the TCB timing the idle gap
+            "ldi        r29,      0x0B"   "\n\t" // all TCBs are 0x0Bn0
+            "ldd        r26,    Y +  6"   "\n\t" // Y + 6 = TCBn.INTFLAGS
+            "sbrs       r26,         0"   "\n\t" // if CAPT is set, the line went idle before this character arrived
+            "rjmp  _rxc_frame_restart"    "\n\t"
+            "std      Y + 6,       r26"   "\n\t" // clear the flags
+            "movw       r26,       r24"   "\n\t" // the frame ended just before this character - that's the old head
+            "sbiw       r26,         1"   "\n\t"
+    #if   SERIAL_RX_BUFFER_SIZE == 2048
+            "andi       r27,      0x07"   "\n\t"
+    #elif SERIAL_RX_BUFFER_SIZE == 1024
+            "andi       r27,      0x03"   "\n\t"
+    #elif SERIAL_RX_BUFFER_SIZE == 512
+            "andi       r27,      0x01"   "\n\t"
+    #endif
+            "std     Z + " _SER_STR(_SER_FREND_OFS) ", r26" "\n\t"
+            "std     Z + " _SER_STR(_SER_FREND_OFSH) ", r27" "\n\t"
+            "ldd        r26,    Z + " _SER_STR(_SER_FRMODE_OFS) "\n\t"
+            "ori        r26,      0x80"   "\n\t" // flag that a frame has ended
+            "std     Z + " _SER_STR(_SER_FRMODE_OFS) ", r26" "\n\t"
+          "_rxc_frame_restart:"           "\n\t"
+            "ldi        r26,         0"   "\n\t" // restart the idle timer
+            "std     Y + 10,       r26"   "\n\t" // Y + 10 = TCBn.CNTL - goes to TEMP
+            "std     Y + 11,       r26"   "\n\t" // Y + 11 = TCBn.CNTH - writes both
+          "_rxc_frame_delim:"             "\n\t"
+            "ldd        r26,    Z + " _SER_STR(_SER_FRMODE_OFS) "\n\t"
+            "sbrs       r26,         0"   "\n\t" // delimiter enabled?
+            "rjmp  _rxc_frame_done"       "\n\t"
+            "ldd        r27,    Z + " _SER_STR(_SER_FRDELIM_OFS) "\n\t"
+            "cpse       r27,       r18"   "\n\t" // is this the delimiter?
+            "rjmp  _rxc_frame_done"       "\n\t"
+            "ori        r26,      0x80"   "\n\t" // if so, the frame ends with it, at the new head
+            "std     Z + " _SER_STR(_SER_FRMODE_OFS) ", r26" "\n\t"
+            "std     Z + " _SER_STR(_SER_FREND_OFS) ", r24" "\n\t"
+            "std     Z + " _SER_STR(_SER_FREND_OFSH) ", r25" "\n\t"
+          "_rxc_frame_done:"              "\n\t"
+            "pop        r27"              "\n\t"
+            "pop        r26"              "\n\t"
+            "rjmp  _end_rxc"              "\n\t"
+            ::); // total: 86, or 84 if buffer full, with framing off.
+        __builtin_unreachable();
+      }
     #elif defined(USE_ASM_RXC) && USE_ASM_RXC == 1
       #warning "USE_ASM_RXC is defined and this has more than one serial port, but the buffer size is not supported, falling back to the classical RXC."
     #else
@@ -281,6 +503,24 @@
           if (i != HardwareSerial._rx_buffer_tail) {
             HardwareSerial._rx_buffer[rxHead] = c;
             HardwareSerial._rx_buffer_head = i;
+            uint8_t mode = HardwareSerial._frame_mode;
+            if (mode) {
+              if (mode & 0x02) {
+                TCB_t* timer = (TCB_t *)(0x0B00 | HardwareSerial._frame_tcb);
+                if (timer->INTFLAGS & TCB_CAPT_bm) {
+                  // line went idle before this character - the frame ended at the old head.
+                  timer->INTFLAGS = TCB_CAPT_bm;
+                  HardwareSerial._frame_end = rxHead;
+                  mode |= 0x80;
+                }
+                timer->CNT = 0;
+              }
+              if ((mode & 0x01) && c == HardwareSerial._frame_delim) {
+                HardwareSerial._frame_end = i;
+                mode |= 0x80;
+              }
+              HardwareSerial._frame_mode = mode;
+            }
           }
         }
       }
@@ -299,8 +539,7 @@
 
     */
 
-    #if USE_ASM_DRE == 1 && (SERIAL_RX_BUFFER_SIZE == 256 || SERIAL_RX_BUFFER_SIZE == 128 || SERIAL_RX_BUFFER_SIZE == 64 || SERIAL_RX_BUFFER_SIZE == 32 || SERIAL_RX_BUFFER_SIZE == 16) && \
-                            (SERIAL_TX_BUFFER_SIZE == 256 || SERIAL_TX_BUFFER_SIZE == 128 || SERIAL_TX_BUFFER_SIZE == 64 || SERIAL_TX_BUFFER_SIZE == 32 || SERIAL_TX_BUFFER_SIZE == 16)
+    #if USE_ASM_DRE == 1 && SERIAL_RX_BUFFER_ASM_OK && SERIAL_TX_BUFFER_ASM_OK
       void __attribute__((naked)) __attribute__((used)) __attribute__((noreturn)) _do_dre(void) {
         __asm__ __volatile__(
         "_do_dre:"                        "\n\t"
@@ -315,33 +554,22 @@
         "_poll_dre:"                      "\n\t"
           "push        r28"               "\n\t"
           "push        r29"               "\n\t"
+    #if SERIAL_TX_BUFFER_SIZE <= 256
           "ldi         r18,        0"     "\n\t"
           "ldd         r28,   Z +  8"     "\n\t"  // usart in Y low byte
     //    "ldd         r29,   Z +  9"     "\n\t"  // usart in Y high byte - wait, this is constant!
           "ldi         r29,     0x08"     "\n\t"  // High byte always 0x08 for USART peripheral: Save-a-clock.
-          "ldd         r25,   Z + 18"     "\n\t"  // tx tail in r25
+          "ldd         r25,   Z + " _SER_STR(_SER_TXTAIL_OFS) "\n\t"  // tx tail in r25
           "movw        r26,      r30"     "\n\t"  // copy of serial in X
           "add         r26,      r25"     "\n\t"  // SerialN + txtail
           "adc         r27,      r18"     "\n\t"  // X = &Serial + txtail
-    #if   SERIAL_RX_BUFFER_SIZE == 256            // RX buffer determines offset from start of class to TX buffer
-          "subi        r26,     0xED"     "\n\t"  // There's no addi/adci, so we instead subtract (65536-(offset we want to add))
-          "sbci        r27,     0xFE"     "\n\t"  // +273
-          "ld          r24,        X"     "\n\t"  // grab the character
-    #elif SERIAL_RX_BUFFER_SIZE == 128
-          "subi        r26,     0x6D"     "\n\t"  //
-          "sbci        r27,     0xFF"     "\n\t"  // +145
-          "ld          r24,        X"     "\n\t"  // grab the character
-    #elif SERIAL_RX_BUFFER_SIZE == 64
-          "subi        r26,     0xAD"     "\n\t"  //
-          "sbci        r27,     0xFF"     "\n\t"  // +81
-          "ld          r24,        X"     "\n\t"  // grab the character
-    #elif SERIAL_RX_BUFFER_SIZE == 32
-          "adiw        r26,     0x33"     "\n\t"  // +49
-          "ld          r24,        X"     "\n\t"  // grab the character
-    #elif SERIAL_RX_BUFFER_SIZE == 16
-          "adiw        r26,     0x23"     "\n\t"  // +33
-          "ld          r24,        X"     "\n\t"  // grab the character
+    #if   (SERIAL_RX_BUFFER_SIZE + _SER_RXBUF_OFS) < 64   // TX buffer is at _SER_RXBUF_OFS + SERIAL_RX_BUFFER_SIZE
+          "adiw        r26, " _SER_STR(_SER_RXBUF_OFS) " + " _SER_STR(SERIAL_RX_BUFFER_SIZE) "\n\t"  // small enough for adiw
+    #else                                         // There's no addi/adci, so we instead subtract (65536-(offset we want to add))
+          "subi        r26, lo8(-(" _SER_STR(_SER_RXBUF_OFS) " + " _SER_STR(SERIAL_RX_BUFFER_SIZE) "))" "\n\t"
+          "sbci        r27, hi8(-(" _SER_STR(_SER_RXBUF_OFS) " + " _SER_STR(SERIAL_RX_BUFFER_SIZE) "))" "\n\t"
     #endif
+          "ld          r24,        X"     "\n\t"  // grab the character
           "ldi         r18,     0x40"     "\n\t"
           "std       Y + 4,      r18"     "\n\t" // Y + 4 = USART.STATUS - clear TXC
           "std       Y + 2,      r24"     "\n\t" // Y + 2 = USART.TXDATAL - write char
@@ -359,13 +587,49 @@
           "andi        r25,     0x0F"     "\n\t" // Wrap the tail around
     #endif
           "ldd         r24,   Y +  5"     "\n\t"  // Y + 5 = USART.CTRLA - get CTRLA into r24
-          "ldd         r18,   Z + 17"     "\n\t"  // txhead into r18
+          "ldd         r18,   Z + " _SER_STR(_SER_TXHEAD_OFS) "\n\t"  // txhead into r18
           "cpse        r18,      r25"     "\n\t"  // if they're the same
           "rjmp  _done_dre_irq"           "\n\t"  // Skipped unless buffer empty.
           "andi        r24,     0xDF"     "\n\t"  // DREIE off
           "std      Y +  5,      r24"     "\n\t"  // write new ctrla
         "_done_dre_irq:"                  "\n\t"  // Beginning of the end of DRE
-          "std      Z + 18,      r25"     "\n\t"  // store new tail
+          "std      Z + " _SER_STR(_SER_TXTAIL_OFS) ", r25" "\n\t"  // store new tail
+    #else
+          // 16-bit TX indices. Same registers, just shuffled around: tail in r24:r25, character in r18, X reused for head.
+          // 6 clocks more than the 8-bit version.
+          "ldd         r28,   Z +  8"     "\n\t"  // usart in Y low byte
+          "ldi         r29,     0x08"     "\n\t"  // High byte always 0x08 for USART peripheral
+          "ldd         r24,   Z + " _SER_STR(_SER_TXTAIL_OFS) "\n\t"  // tx tail low byte
+          "ldd         r25,   Z + " _SER_STR(_SER_TXTAIL_OFSH) "\n\t"  // tx tail high byte
+          "movw        r26,      r30"     "\n\t"  // copy of serial in X
+          "add         r26,      r24"     "\n\t"  // SerialN + txtail
+          "adc         r27,      r25"     "\n\t"  // X = &Serial + txtail
+          "subi        r26, lo8(-(" _SER_STR(_SER_RXBUF_OFS) " + " _SER_STR(SERIAL_RX_BUFFER_SIZE) "))" "\n\t"
+          "sbci        r27, hi8(-(" _SER_STR(_SER_RXBUF_OFS) " + " _SER_STR(SERIAL_RX_BUFFER_SIZE) "))" "\n\t"
+          "ld          r18,        X"     "\n\t"  // grab the character
+          "ldi         r26,     0x40"     "\n\t"
+          "std       Y + 4,      r26"     "\n\t" // Y + 4 = USART.STATUS - clear TXC
+          "std       Y + 2,      r18"     "\n\t" // Y + 2 = USART.TXDATAL - write char
+          "adiw        r24,        1"     "\n\t" // increment txtail, we wrote that character
+      #if   SERIAL_TX_BUFFER_SIZE == 2048
+          "andi        r25,     0x07"     "\n\t" // Wrap the tail around - low byte wraps naturally
+      #elif SERIAL_TX_BUFFER_SIZE == 1024
+          "andi        r25,     0x03"     "\n\t" // Wrap the tail around
+      #elif SERIAL_TX_BUFFER_SIZE == 512
+          "andi        r25,     0x01"     "\n\t" // Wrap the tail around
+      #endif
+          "ldd         r18,   Y +  5"     "\n\t"  // Y + 5 = USART.CTRLA - get CTRLA into r18
+          "ldd         r26,   Z + " _SER_STR(_SER_TXHEAD_OFS) "\n\t"  // txhead into X
+          "ldd         r27,   Z + " _SER_STR(_SER_TXHEAD_OFSH) "\n\t"
+          "cp          r26,      r24"     "\n\t"  // compare head and new tail
+          "cpc         r27,      r25"     "\n\t"
+          "brne  _done_dre_irq"           "\n\t"  // Taken unless buffer empty.
+          "andi        r18,     0xDF"     "\n\t"  // DREIE off
+          "std      Y +  5,      r18"     "\n\t"  // write new ctrla
+        "_done_dre_irq:"                  "\n\t"  // Beginning of the end of DRE
+          "std      Z + " _SER_STR(_SER_TXTAIL_OFS) ", r24" "\n\t"  // store new tail. Nothing can interrupt us between these
+          "std      Z + " _SER_STR(_SER_TXTAIL_OFSH) ", r25" "\n\t"  // and writers read it atomically.
+    #endif
           "pop         r29"               "\n\t"  // pop Y
           "pop         r28"               "\n\t"  // finish popping Y
     #if PROGMEM_SIZE > 8192
@@ -384,6 +648,7 @@
           "pop         r18"               "\n\t"  // pop old r18
           "pop         r31"               "\n\t"  // pop the Z that the isr pushed.
           "pop         r30"               "\n\t"
+          ISR_TIMING_EXIT_ASM                     // nothing unless built with CORE_ISR_TIMING
           "reti"                          "\n"   // and RETI!
           ::);
         __builtin_unreachable();
@@ -449,8 +714,7 @@
 
             return;
           }
-    #if !(USE_ASM_DRE == 1 && (SERIAL_RX_BUFFER_SIZE == 256 || SERIAL_RX_BUFFER_SIZE == 128  || SERIAL_RX_BUFFER_SIZE == 64 || SERIAL_RX_BUFFER_SIZE == 32 || SERIAL_RX_BUFFER_SIZE == 16) && \
-                              (SERIAL_TX_BUFFER_SIZE == 256 || SERIAL_TX_BUFFER_SIZE == 128  || SERIAL_TX_BUFFER_SIZE == 64 || SERIAL_TX_BUFFER_SIZE == 32 || SERIAL_TX_BUFFER_SIZE == 16))
+    #if !(USE_ASM_DRE == 1 && SERIAL_RX_BUFFER_ASM_OK && SERIAL_TX_BUFFER_ASM_OK)
             _tx_data_empty_irq(*this);
     #else // We're using ASM DRE
         void * thisSerial = this;
@@ -695,14 +959,25 @@
       // Note: Does not change output pins
       // though the datasheetsays turning the TX module sets it to input.
       _state = 0;
+      stopFraming();
     }
 
+    // With buffers over 256b, the RX ISR can change the 16-bit head between us reading the two halves of it, hence RX_BUFFER_ATOMIC.
+    // Nothing but us changes the tail.
     int HardwareSerial::available(void) {
-      return ((unsigned int)(SERIAL_RX_BUFFER_SIZE + _rx_buffer_head - _rx_buffer_tail)) & (SERIAL_RX_BUFFER_SIZE - 1);   //% SERIAL_RX_BUFFER_SIZE;
+      rx_buffer_index_t head;
+      RX_BUFFER_ATOMIC {
+        head = _rx_buffer_head;
+      }
+      return ((unsigned int)(SERIAL_RX_BUFFER_SIZE + head - _rx_buffer_tail)) & (SERIAL_RX_BUFFER_SIZE - 1);   //% SERIAL_RX_BUFFER_SIZE;
     }
 
     int HardwareSerial::peek(void) {
-      if (_rx_buffer_head == _rx_buffer_tail) {
+      rx_buffer_index_t head;
+      RX_BUFFER_ATOMIC {
+        head = _rx_buffer_head;
+      }
+      if (head == _rx_buffer_tail) {
         return -1;
       } else {
         return _rx_buffer[_rx_buffer_tail];
@@ -710,16 +985,206 @@
     }
 
     int HardwareSerial::read(void) {
+      rx_buffer_index_t head;
+      RX_BUFFER_ATOMIC {
+        head = _rx_buffer_head;
+      }
       // if the head isn't ahead of the tail, we don't have any characters
-      if (_rx_buffer_head == _rx_buffer_tail) {
+      if (head == _rx_buffer_tail) {
         return -1;
       } else {
         unsigned char c = _rx_buffer[_rx_buffer_tail];
-        _rx_buffer_tail = (rx_buffer_index_t)(_rx_buffer_tail + 1) & (SERIAL_RX_BUFFER_SIZE - 1);   // % SERIAL_RX_BUFFER_SIZE;
+        rx_buffer_index_t tail = (rx_buffer_index_t)(_rx_buffer_tail + 1) & (SERIAL_RX_BUFFER_SIZE - 1);   // % SERIAL_RX_BUFFER_SIZE;
+        RX_BUFFER_ATOMIC {
+          _rx_buffer_tail = tail;
+        }
         return c;
       }
     }
 
+    /* Block read. Copies everything that is already in the ring buffer (up to length bytes) into the buffer in at most two
+     * chunks, and moves the tail once. Never waits - returns the number of bytes copied, which may be 0. This is what makes
+     * readBytes() fast: Stream::readBytes() calls timedRead(), which calls read() and millis() for every single byte.
+     */
+    size_t HardwareSerial::read(uint8_t *buffer, size_t length) {
+      rx_buffer_index_t tail = _rx_buffer_tail; // only we ever write tail, so this needs no protection
+      rx_buffer_index_t head;
+      RX_BUFFER_ATOMIC {
+        head = _rx_buffer_head;
+      }
+      uint16_t count = (uint16_t)(head - tail) & (SERIAL_RX_BUFFER_SIZE - 1);
+      if (count > length) {
+        count = (uint16_t) length;
+      }
+      if (count == 0) {
+        return 0;
+      }
+      uint16_t chunk = SERIAL_RX_BUFFER_SIZE - tail;  // contiguous data before the ring wraps
+      if (chunk > count) {
+        chunk = count;
+      }
+      memcpy(buffer, (const uint8_t *) &_rx_buffer[tail], chunk);
+      if (count > chunk) {
+        memcpy(buffer + chunk, (const uint8_t *) _rx_buffer, count - chunk);
+      }
+      tail = (rx_buffer_index_t)((tail + count) & (SERIAL_RX_BUFFER_SIZE - 1));
+      RX_BUFFER_ATOMIC {
+        _rx_buffer_tail = tail;
+      }
+      return count;
+    }
+
+    /* Replaces Stream::readBytes() for HardwareSerial - whatever is already buffered is copied out in one go, and we only
+     * fall back to the timed path (waiting up to the timeout for the next character) when we run out. Same semantics:
+     * returns when length bytes have been read or the timeout passes with nothing received.
+     */
+    size_t HardwareSerial::readBytes(char *buffer, size_t length) {
+      size_t count = read((uint8_t *) buffer, length);
+      while (count < length) {
+        int c = timedRead();
+        if (c < 0) {
+          break;
+        }
+        buffer[count++] = (char) c;
+        count += read((uint8_t *) buffer + count, length - count);
+      }
+      return count;
+    }
+
+    /* Frame detection. The RXC ISR notes where a frame ends - either right after a delimiter character, or, if a TCB is
+     * timing the gap between characters, just before the first character that arrives after the line was idle for the
+     * timeout. It records the head index at that point in _frame_end and sets bit 7 of _frame_mode. frameAvailable()
+     * turns that into a length. None of this costs anything but the test of _frame_mode in the ISR while it's off.
+     */
+    void HardwareSerial::setFrameDelimiter(uint8_t delimiter) {
+      uint8_t oldSREG = SREG;
+      cli();
+      _frame_delim = delimiter;
+      if (!_frame_mode) {
+        _frame_end = _rx_buffer_head;
+      }
+      _frame_mode |= 0x01;
+      SREG = oldSREG;
+    }
+
+    /* The TCB runs in periodic interrupt mode (with the interrupt off) from CLK_PER, and the ISR zeroes the count on every
+     * character, so CAPT only gets set if the line stays quiet for bitTimes. The bit time is taken from the BAUD register,
+     * so call this after begin(), and again if the baud rate is changed. Returns false if the timeout doesn't fit in the
+     * timer, even at CLK_PER/2.
+     */
+    bool HardwareSerial::setFrameTimeout(TCB_t &timer, uint16_t bitTimes) {
+      volatile USART_t * MyUSART = _hwserial_module;
+      uint32_t clocks = (uint32_t) MyUSART->BAUD * bitTimes;
+      clocks >>= ((MyUSART->CTRLB & USART_RXMODE0_bm) ? 3 : 2); // BAUD is 64 * F_CPU / (S * baud): 16x oversampling, or 8x with U2X
+      uint8_t clksel = TCB_CLKSEL_DIV1_gc;
+      if (clocks > 0xFFFF) {
+        clocks >>= 1;
+        clksel = TCB_CLKSEL_DIV2_gc;
+        if (clocks > 0xFFFF) {
+          return false;
+        }
+      }
+      if (clocks == 0) {
+        return false;
+      }
+      timer.CTRLA     = 0;
+      timer.CTRLB     = TCB_CNTMODE_INT_gc;
+      timer.CCMP      = (uint16_t) clocks;
+      timer.CNT       = 0;
+      timer.INTFLAGS  = TCB_CAPT_bm;
+      uint8_t oldSREG = SREG;
+      cli();
+      _frame_tcb  = (uint8_t)(uint16_t) &timer;
+      if (!_frame_mode) {
+        _frame_end = _rx_buffer_head;
+      }
+      _frame_mode = (_frame_mode & 0x81) | 0x02;
+      timer.CTRLA = clksel | TCB_ENABLE_bm;
+      SREG = oldSREG;
+      return true;
+    }
+
+    void HardwareSerial::stopFraming() {
+      uint8_t oldSREG = SREG;
+      cli();
+      if (_frame_mode & 0x02) {
+        ((TCB_t *)(0x0B00 | _frame_tcb))->CTRLA = 0;
+      }
+      _frame_mode = 0;
+      SREG = oldSREG;
+    }
+
+    /* Returns the number of bytes from the tail up to and including the end of the most recent complete frame - so if several
+     * frames are waiting, you get all of them; read up to the delimiter to split them. 0 if no complete frame is buffered.
+     * With an idle timeout, the ISR only finds out the line went idle when the next character arrives, so we also check
+     * the timer here - that's how the last frame before a pause gets reported without waiting for the next one.
+     */
+    int HardwareSerial::frameAvailable() {
+      uint8_t oldSREG = SREG;
+      cli();
+      uint8_t mode = _frame_mode;
+      rx_buffer_index_t head = _rx_buffer_head;
+      rx_buffer_index_t tail = _rx_buffer_tail;
+      if ((mode & 0x02) && head != _frame_end) {
+        if (((TCB_t *)(0x0B00 | _frame_tcb))->INTFLAGS & TCB_CAPT_bm) {
+          _frame_end = head;
+          mode |= 0x80;
+        }
+      }
+      uint16_t len = 0;
+      if (mode & 0x80) {
+        len          = (uint16_t)(_frame_end - tail) & (SERIAL_RX_BUFFER_SIZE - 1);
+        uint16_t avl = (uint16_t)(head - tail)       & (SERIAL_RX_BUFFER_SIZE - 1);
+        if (len == 0 || len > avl) { // all of it has been read already.
+          len = 0;
+          mode &= 0x7F;
+        }
+      }
+      _frame_mode = mode;
+      SREG = oldSREG;
+      return len;
+    }
+
+    /* Zero-copy access to the ring buffers. Everything between the RX tail and head belongs to the reader - the ISR only
+     * ever writes at the head - so we can hand out pointers into it, and the data stays put until consume() moves the tail
+     * past it. Likewise everything from the TX head up to one short of the tail belongs to the writer until commit().
+     * The buffers are volatile because the ISRs touch them; the parts we hand out aren't touched while they're ours.
+     */
+    size_t HardwareSerial::readSpan(const uint8_t **data) {
+      const uint8_t *second;
+      size_t firstLength;
+      readSpans(data, &firstLength, &second);
+      return firstLength;
+    }
+
+    size_t HardwareSerial::readSpans(const uint8_t **first, size_t *firstLength, const uint8_t **second) {
+      rx_buffer_index_t tail = _rx_buffer_tail;
+      rx_buffer_index_t head;
+      RX_BUFFER_ATOMIC {
+        head = _rx_buffer_head;
+      }
+      uint16_t count = (uint16_t)(head - tail) & (SERIAL_RX_BUFFER_SIZE - 1);
+      uint16_t chunk = SERIAL_RX_BUFFER_SIZE - tail;  // contiguous data before the ring wraps
+      if (chunk > count) {
+        chunk = count;
+      }
+      *first        = (const uint8_t *) &_rx_buffer[tail];
+      *firstLength  = chunk;
+      *second       = (count > chunk) ? (const uint8_t *) _rx_buffer : NULL;
+      return count;
+    }
+
+    void HardwareSerial::consume(size_t count) {
+      size_t avail = (size_t) available();
+      if (count > avail) {
+        count = avail;
+      }
+      rx_buffer_index_t tail = (rx_buffer_index_t)((_rx_buffer_tail + count) & (SERIAL_RX_BUFFER_SIZE - 1));
+      RX_BUFFER_ATOMIC {
+        _rx_buffer_tail = tail;
+      }
+    }
+
       int HardwareSerial::availableForWrite(void) {
         tx_buffer_index_t head;
         tx_buffer_index_t tail;
@@ -767,11 +1232,15 @@
 
       size_t HardwareSerial::write(uint8_t c) {
         _state |= 1; // Record that we have written to serial since it was begun.
+        tx_buffer_index_t tail;
+        TX_BUFFER_ATOMIC {
+          tail = _tx_buffer_tail;
+        }
         // If the buffer and the data register is empty, just write the byte
         // to the data register and be done. This shortcut helps
         // significantly improve the effective data rate at high (>
         // 500kbit/s) bit rates, where interrupt overhead becomes a slowdown.
-        if ((_tx_buffer_head == _tx_buffer_tail) && ((*_hwserial_module).STATUS & USART_DREIF_bm)) {
+        if ((_tx_buffer_head == tail) && ((*_hwserial_module).STATUS & USART_DREIF_bm)) {
           if (_state & 2) { // in half duplex mode, we turn off RXC interrupt
             uint8_t ctrla = (*_hwserial_module).CTRLA;
             ctrla &= ~USART_RXCIE_bm;
@@ -804,11 +1273,16 @@
 
         // If the output buffer is full, there's nothing we can do other than to
         // wait for the interrupt handler to empty it a bit (or emulate interrupts)
-        while (i == _tx_buffer_tail) {
+        while (i == tail) {
           _poll_tx_data_empty();
+          TX_BUFFER_ATOMIC {
+            tail = _tx_buffer_tail;
+          }
         }
         _tx_buffer[_tx_buffer_head] = c;
-        _tx_buffer_head = i;
+        TX_BUFFER_ATOMIC {
+          _tx_buffer_head = i;
+        }
         if (_state & 2) { // in half duplex mode, we turn off RXC interrupt
           uint8_t ctrla = (*_hwserial_module).CTRLA;
           ctrla &= ~USART_RXCIE_bm;
@@ -822,6 +1296,118 @@
         return 1;
       }
 
+      /* Block write. Print::write(buffer, size) just calls write(uint8_t) size times, which means that for every byte we
+       * check head against tail, test DREIF, and do a read-modify-write of CTRLA. At 1-2 Mbaud that overhead is a significant
+       * fraction of a byte-time. Instead, we figure out how much room there is in the ring, copy as much of the buffer as will
+       * fit in at most two chunks (one up to the end of the ring, one from the start), publish the new head once, and then
+       * turn on DREIE (and in half duplex mode, do the RXCIE/TXCIE dance) once per chunk. If the data won't all fit, we then
+       * wait for room exactly as write(uint8_t) does, using _poll_tx_data_empty() so this works from ISRs and with interrupts
+       * disabled as well (which is still a bad idea - see the long rant in write() above). Note that we do not take the
+       * "write straight to TXDATAL" shortcut for the first byte - with DREIE on and DREIF set, the DRE ISR fires right away.
+       * See libraries/DxCore/examples/SerialBlockWrite for a sketch that measures this against the byte loop.
+       * -Spence
+       */
+      size_t HardwareSerial::write(const uint8_t *buffer, size_t size) {
+        size_t remaining = size;
+        if (remaining == 0) {
+          return 0;
+        }
+        _state |= 1; // Record that we have written to serial since it was begun.
+        volatile USART_t* MyUSART = _hwserial_module;
+        do {
+          tx_buffer_index_t head = _tx_buffer_head; // only we ever write head, so this needs no protection
+          tx_buffer_index_t tail;
+          TX_BUFFER_ATOMIC {
+            tail = _tx_buffer_tail;
+          }
+          // We can fill up to one short of the tail. Do the math in 16 bits since a 256b ring doesn't fit in a tx_buffer_index_t.
+          uint16_t room = (uint16_t)(tail - head - 1) & (SERIAL_TX_BUFFER_SIZE - 1);
+          if (room == 0) {
+            // Buffer full - wait for the ISR to make room (or emulate it if interrupts are off)
+            _poll_tx_data_empty();
+            continue;
+          }
+          if (room > remaining) {
+            room = (uint16_t) remaining;
+          }
+          uint16_t chunk = SERIAL_TX_BUFFER_SIZE - head;  // contiguous space before the ring wraps
+          if (chunk > room) {
+            chunk = room;
+          }
+          memcpy((uint8_t *) &_tx_buffer[head], buffer, chunk);
+          if (room > chunk) {
+            memcpy((uint8_t *) _tx_buffer, buffer + chunk, room - chunk);
+          }
+          buffer    += room;
+          remaining -= room;
+          head = (tx_buffer_index_t)((head + room) & (SERIAL_TX_BUFFER_SIZE - 1));
+          TX_BUFFER_ATOMIC {
+            _tx_buffer_head = head;
+          }
+          if (_state & 2) { // in half duplex mode, we turn off RXC interrupt
+            uint8_t ctrla = (*MyUSART).CTRLA;
+            ctrla &= ~USART_RXCIE_bm;
+            ctrla |= USART_TXCIE_bm | USART_DREIE_bm;
+            (*MyUSART).STATUS = USART_TXCIF_bm;
+            (*MyUSART).CTRLA = ctrla;
+          } else {
+            // Enable "data register empty interrupt"
+            (*MyUSART).CTRLA |= USART_DREIE_bm;
+          }
+        } while (remaining);
+        return size;
+      }
+
+      /* The TX half of the zero-copy API. Returns the contiguous free space starting at the head, which may be less than
+       * availableForWrite() if the free space wraps around the end of the ring; fill it, commit() what you wrote, and ask
+       * again for the rest. Never waits for room, except that with interrupts disabled, a full buffer is given the same
+       * nudge that write() would give it.
+       */
+      size_t HardwareSerial::writeSpan(uint8_t **data) {
+        tx_buffer_index_t head = _tx_buffer_head; // only we ever write head, so this needs no protection
+        tx_buffer_index_t tail;
+        TX_BUFFER_ATOMIC {
+          tail = _tx_buffer_tail;
+        }
+        uint16_t room = (uint16_t)(tail - head - 1) & (SERIAL_TX_BUFFER_SIZE - 1);
+        if (room == 0) {
+          _poll_tx_data_empty();
+          TX_BUFFER_ATOMIC {
+            tail = _tx_buffer_tail;
+          }
+          room = (uint16_t)(tail - head - 1) & (SERIAL_TX_BUFFER_SIZE - 1);
+        }
+        uint16_t chunk = SERIAL_TX_BUFFER_SIZE - head;  // contiguous space before the ring wraps
+        if (chunk > room) {
+          chunk = room;
+        }
+        *data = (uint8_t *) &_tx_buffer[head];
+        return chunk;
+      }
+
+      // Publish count bytes written into the span from writeSpan() - the caller must not commit more than that returned.
+      void HardwareSerial::commit(size_t count) {
+        if (count == 0) {
+          return;
+        }
+        _state |= 1; // Record that we have written to serial since it was begun.
+        volatile USART_t* MyUSART = _hwserial_module;
+        tx_buffer_index_t head = (tx_buffer_index_t)((_tx_buffer_head + count) & (SERIAL_TX_BUFFER_SIZE - 1));
+        TX_BUFFER_ATOMIC {
+          _tx_buffer_head = head;
+        }
+        if (_state & 2) { // in half duplex mode, we turn off RXC interrupt
+          uint8_t ctrla = (*MyUSART).CTRLA;
+          ctrla &= ~USART_RXCIE_bm;
+          ctrla |= USART_TXCIE_bm | USART_DREIE_bm;
+          (*MyUSART).STATUS = USART_TXCIF_bm;
+          (*MyUSART).CTRLA = ctrla;
+        } else {
+          // Enable "data register empty interrupt"
+          (*MyUSART).CTRLA |= USART_DREIE_bm;
+        }
+      }
+
       void HardwareSerial::printHex(const uint8_t b) {
         char x = (b >> 4) | '0';
         if (x > '9')
@@ -83,13 +83,16 @@
     }
   #endif
 
-  #if !(defined(USE_ASM_RXC) && (USE_ASM_RXC == 1 || USE_ASM_RXC == 2) && (SERIAL_RX_BUFFER_SIZE == 256 || SERIAL_RX_BUFFER_SIZE == 128 || SERIAL_RX_BUFFER_SIZE == 64 || SERIAL_RX_BUFFER_SIZE == 32 || SERIAL_RX_BUFFER_SIZE == 16) /* && defined(USART1)*/)
+  #if !(defined(USE_ASM_RXC) && (USE_ASM_RXC == 1 || USE_ASM_RXC == 2) && SERIAL_RX_BUFFER_ASM_OK)
     ISR(USART0_RXC_vect) {
+      ISR_TIMING_ENTER(ISR_TIMING_USART_RXC(0));
       HardwareSerial::_rx_complete_irq(Serial);
+      ISR_TIMING_EXIT();
     }
   #else
       ISR(USART0_RXC_vect, ISR_NAKED) {
         __asm__ __volatile__(
+              ISR_TIMING_ENTER_ASM(ISR_TIMING_USART_RXC(0)) // nothing unless built with CORE_ISR_TIMING
               "push      r30"     "\n\t" //we start out 5-6 clocks behind the ball, then do 2 push + 2 ldi + 2-3 for jump = 11 or 13 clocks to _do_rxc (and dre is the same)
               "push      r31"     "\n\t"
               "cbi   0x1F, 0"     "\n\t"
@@ -104,15 +107,16 @@
         __builtin_unreachable();
     }
   #endif
-  #if !(defined(USE_ASM_DRE) && USE_ASM_DRE == 1 && \
-       (SERIAL_RX_BUFFER_SIZE == 256 || SERIAL_RX_BUFFER_SIZE == 128 || SERIAL_RX_BUFFER_SIZE == 64 || SERIAL_RX_BUFFER_SIZE == 32 || SERIAL_RX_BUFFER_SIZE == 16) && \
-       (SERIAL_TX_BUFFER_SIZE == 256 || SERIAL_TX_BUFFER_SIZE == 128 || SERIAL_TX_BUFFER_SIZE == 64 || SERIAL_TX_BUFFER_SIZE == 32 || SERIAL_TX_BUFFER_SIZE == 16))
+  #if !(defined(USE_ASM_DRE) && USE_ASM_DRE == 1 && SERIAL_RX_BUFFER_ASM_OK && SERIAL_TX_BUFFER_ASM_OK)
     ISR(USART0_DRE_vect) {
+      ISR_TIMING_ENTER(ISR_TIMING_USART_DRE(0));
       HardwareSerial::_tx_data_empty_irq(Serial);
+      ISR_TIMING_EXIT();
     }
   #else
     ISR(USART0_DRE_vect, ISR_NAKED) {
       __asm__ __volatile__(
+                ISR_TIMING_ENTER_ASM(ISR_TIMING_USART_DRE(0)) // nothing unless built with CORE_ISR_TIMING
                 "push  r30"       "\n\t"
                 "push  r31"       "\n\t"
                 "cbi   0x1F, 0"   "\n\t"
@@ -55,13 +55,16 @@
     }
   #endif
 
-  #if !(defined(USE_ASM_RXC) && (USE_ASM_RXC == 1 || USE_ASM_RXC == 2) && (SERIAL_RX_BUFFER_SIZE == 256 || SERIAL_RX_BUFFER_SIZE == 128 || SERIAL_RX_BUFFER_SIZE == 64 || SERIAL_RX_BUFFER_SIZE == 32 || SERIAL_RX_BUFFER_SIZE == 16) /* && defined(USART1)*/)
+  #if !(defined(USE_ASM_RXC) && (USE_ASM_RXC == 1 || USE_ASM_RXC == 2) && SERIAL_RX_BUFFER_ASM_OK)
     ISR(USART1_RXC_vect) {
+      ISR_TIMING_ENTER(ISR_TIMING_USART_RXC(1));
       HardwareSerial::_rx_complete_irq(Serial1);
+      ISR_TIMING_EXIT();
     }
   #else
       ISR(USART1_RXC_vect, ISR_NAKED) {
         __asm__ __volatile__(
+              ISR_TIMING_ENTER_ASM(ISR_TIMING_USART_RXC(1)) // nothing unless built with CORE_ISR_TIMING
               "push      r30"     "\n\t"
               "push      r31"     "\n\t"
               "sbi   0x1F, 0"     "\n\t"
@@ -76,15 +79,16 @@
         __builtin_unreachable();
     }
   #endif
-  #if !(defined(USE_ASM_DRE) && USE_ASM_DRE == 1 && \
-       (SERIAL_RX_BUFFER_SIZE == 256 || SERIAL_RX_BUFFER_SIZE == 128 || SERIAL_RX_BUFFER_SIZE == 64 || SERIAL_RX_BUFFER_SIZE == 32 || SERIAL_RX_BUFFER_SIZE == 16) && \
-       (SERIAL_TX_BUFFER_SIZE == 256 || SERIAL_TX_BUFFER_SIZE == 128 || SERIAL_TX_BUFFER_SIZE == 64 || SERIAL_TX_BUFFER_SIZE == 32 || SERIAL_TX_BUFFER_SIZE == 16))
+  #if !(defined(USE_ASM_DRE) && USE_ASM_DRE == 1 && SERIAL_RX_BUFFER_ASM_OK && SERIAL_TX_BUFFER_ASM_OK)
     ISR(USART1_DRE_vect) {
+      ISR_TIMING_ENTER(ISR_TIMING_USART_DRE(1));
       HardwareSerial::_tx_data_empty_irq(Serial1);
+      ISR_TIMING_EXIT();
     }
   #else
     ISR(USART1_DRE_vect, ISR_NAKED) {
       __asm__ __volatile__(
+                ISR_TIMING_ENTER_ASM(ISR_TIMING_USART_DRE(1)) // nothing unless built with CORE_ISR_TIMING
                 "push  r30"       "\n\t"
                 "push  r31"       "\n\t"
                 "sbi   0x1F, 0"   "\n\t"
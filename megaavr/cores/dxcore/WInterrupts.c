@@ -147,6 +147,7 @@
   void __attribute__((naked)) __attribute__((used)) __attribute__((noreturn)) isrBody() {
     asm volatile (
      "AttachedISR:"      "\n\t" // as the scene opens, we have r16 on the stack already, portnumber x 2 in the r16
+      ISR_TIMING_ENTER_ASM(ISR_TIMING_ATTACH) // nothing unless built with CORE_ISR_TIMING
       "push  r0"         "\n\t" // so we start with a normal prologue
       "in    r0, 0x3f"   "\n\t" // The SREG
       "push  r0"         "\n\t" // on the stack
@@ -227,6 +228,7 @@
       "out   0x3f,  r0"   "\n\t" // between these is where there had been stuff added to the stack that we flushed.
       "pop   r0"          "\n\t"
       "pop   r16"         "\n\t" // this was the reg we pushed back in the port-specific file.
+      ISR_TIMING_EXIT_ASM
       "reti"              "\n"  // now we should have the pointer to the return address fopr the ISR on top of the stack, so reti're
       :: "x" ((uint16_t)(&intFunc))
       );
@@ -236,6 +238,7 @@
   void __attribute__((naked)) __attribute__((used)) __attribute__((noreturn)) isrBody() {
     asm volatile (
      "AttachedISR:"      "\n\t" // as the scene opens, we have r16 on the stack already, portnumber x 2 in the r16
+      ISR_TIMING_ENTER_ASM(ISR_TIMING_ATTACH) // nothing unless built with CORE_ISR_TIMING
       "push  r0"         "\n\t" // so we start with a normal prologue
       "in    r0, 0x3f"   "\n\t" // The SREG
       "push  r0"         "\n\t" // on the stack
@@ -310,6 +313,7 @@
       "out   0x3f,  r0"   "\n\t" // between these is where there had been stuff added to the stack that we flushed.
       "pop   r0"          "\n\t"
       "pop   r16"         "\n\t" // this was the reg we pushed back in the port-specific file.
+      ISR_TIMING_EXIT_ASM
       "reti"              "\n"  // now we should have the pointer to the return address fopr the ISR on top of the stack, so reti're
       :: "x" ((uint16_t)(&intFunc))
       );
@@ -602,7 +606,9 @@
 
   #define IMPLEMENT_ISR(vect, port) \
   ISR(vect) { \
+    ISR_TIMING_ENTER(ISR_TIMING_ATTACH);\
     port_interrupt_handler(port);\
+    ISR_TIMING_EXIT();\
   } \
 
 
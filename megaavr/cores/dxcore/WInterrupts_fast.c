@@ -0,0 +1,59 @@
+/* This is part of DxCore. Open source software (LGPL 2.1) see License.md for more info.
+ *
+ * attachInterruptFast() and detachInterruptFast() - turn on and off a pin interrupt whose ISR was defined with
+ * ATTACH_INTERRUPT_FAST(). All these do is set the ISC bits in PINnCTRL; the handler is bound at compile time
+ * by the macro, because that's the only way to get an ISR that doesn't have to go through a function pointer.
+ * They are not in WInterrupts.c because, with "attach on all ports", anything in that file drags in every port
+ * vector, and the one the sketch defined with ATTACH_INTERRUPT_FAST() would then be defined twice.
+ */
+
+#include <Arduino.h>
+#include "wiring_private.h"
+
+void attachInterruptFast(uint8_t pin, uint8_t mode) {
+  if (pin >= NUM_TOTAL_PINS) {
+    return;
+  }
+  const pin_descriptor_t *desc = &digital_pin_to_descriptor[pin];
+  if (desc->bit_mask == NOT_A_PIN) {
+    return;
+  }
+  switch (mode) {
+    case CHANGE:
+      mode = PORT_ISC_BOTHEDGES_gc;
+      break;
+    case FALLING:
+      mode = PORT_ISC_FALLING_gc;
+      break;
+    case RISING:
+      mode = PORT_ISC_RISING_gc;
+      break;
+    case LOW:
+      mode = PORT_ISC_LEVEL_gc;
+      break;
+    default:
+      return;
+  }
+  volatile uint8_t *pin_ctrl = _pinDescToPINnCTRL(desc);
+  uint8_t oldSREG = SREG;
+  cli();
+  *pin_ctrl = (*pin_ctrl & ~PORT_ISC_gm) | mode;
+  SREG = oldSREG;
+}
+
+void detachInterruptFast(uint8_t pin) {
+  if (pin >= NUM_TOTAL_PINS) {
+    return;
+  }
+  const pin_descriptor_t *desc = &digital_pin_to_descriptor[pin];
+  if (desc->bit_mask == NOT_A_PIN) {
+    return;
+  }
+  volatile uint8_t *pin_ctrl = _pinDescToPINnCTRL(desc);
+  uint8_t oldSREG = SREG;
+  cli();
+  *pin_ctrl &= ~PORT_ISC_gm;
+  SREG = oldSREG;
+  // and clear the flag, in case it was set between the last time the ISR ran and now.
+  *((volatile uint8_t *)(uint16_t)(((desc->pin_ctrl >> 5) << 2) + 3)) = desc->bit_mask;
+}
@@ -0,0 +1,100 @@
+/* isr_timing.c - records of how long the core's own ISRs take, when built with CORE_ISR_TIMING.
+ * This is part of DxCore. Open source software (LGPL 2.1) see License.md for more info.
+ * See isr_timing.h for how it works. The symbols the assembly uses are marked used so that LTO leaves them alone.
+ */
+
+#include "Arduino.h"
+
+#if defined(CORE_ISR_TIMING)
+
+volatile uint16_t _isr_timing_start __attribute__((used));
+volatile uint8_t  _isr_timing_id    __attribute__((used));
+static isr_timing_t _isr_timing[ISR_TIMING_COUNT];
+
+void init_isr_timing() {
+  _ISR_TIMING_TIMER.CCMP  = 0xFFFF;
+  _ISR_TIMING_TIMER.CTRLB = TCB_CNTMODE_INT_gc;
+  _ISR_TIMING_TIMER.CTRLA = TCB_CLKSEL_DIV1_gc | TCB_ENABLE_bm;
+}
+
+/* Called with interrupts off, from the end of an ISR */
+void __attribute__((used)) _isrTimingEnd(uint16_t now) {
+  uint16_t elapsed = now - _isr_timing_start;
+  isr_timing_t *t = &_isr_timing[_isr_timing_id];
+  if (elapsed < t->min || t->count == 0) {
+    t->min = elapsed;
+  }
+  if (elapsed > t->max) {
+    t->max = elapsed;
+  }
+  t->total += elapsed;
+  t->count++;
+}
+
+/* ISR_TIMING_EXIT_ASM calls this right before the reti of a naked ISR, where every register belongs to the code that
+ * was interrupted. Read the timer first, then save SREG and everything _isrTimingEnd() is allowed to clobber. */
+void __attribute__((naked)) __attribute__((used)) _isrTimingExit() {
+  __asm__ __volatile__(
+    "push       r25"              "\n\t"
+    "push       r24"              "\n\t"
+    "lds        r24, " _ISR_TIMING_CNTL "\n\t"
+    "lds        r25, " _ISR_TIMING_CNTH "\n\t"
+    "push        r0"              "\n\t"
+    "in          r0,      0x3F"   "\n\t"
+    "push        r0"              "\n\t"
+    "push        r1"              "\n\t"
+    "clr         r1"              "\n\t" // C code expects r1 to be zero
+    "push       r18"              "\n\t"
+    "push       r19"              "\n\t"
+    "push       r20"              "\n\t"
+    "push       r21"              "\n\t"
+    "push       r22"              "\n\t"
+    "push       r23"              "\n\t"
+    "push       r26"              "\n\t"
+    "push       r27"              "\n\t"
+    "push       r30"              "\n\t"
+    "push       r31"              "\n\t"
+#if PROGMEM_SIZE > 8192
+    "call  _isrTimingEnd"         "\n\t" // now in r24:r25
+#else
+    "rcall _isrTimingEnd"         "\n\t"
+#endif
+    "pop        r31"              "\n\t"
+    "pop        r30"              "\n\t"
+    "pop        r27"              "\n\t"
+    "pop        r26"              "\n\t"
+    "pop        r23"              "\n\t"
+    "pop        r22"              "\n\t"
+    "pop        r21"              "\n\t"
+    "pop        r20"              "\n\t"
+    "pop        r19"              "\n\t"
+    "pop        r18"              "\n\t"
+    "pop         r1"              "\n\t"
+    "pop         r0"              "\n\t"
+    "out       0x3F,        r0"   "\n\t"
+    "pop         r0"              "\n\t"
+    "pop        r24"              "\n\t"
+    "pop        r25"              "\n\t"
+    "ret"                         "\n"
+    ::);
+}
+
+void isrTimingGet(uint8_t id, isr_timing_t *dest) {
+  if (id >= ISR_TIMING_COUNT) {
+    memset(dest, 0, sizeof(isr_timing_t));
+    return;
+  }
+  uint8_t oldSREG = SREG;
+  cli();
+  *dest = _isr_timing[id];
+  SREG = oldSREG;
+}
+
+void isrTimingReset() {
+  uint8_t oldSREG = SREG;
+  cli();
+  memset(_isr_timing, 0, sizeof(_isr_timing));
+  SREG = oldSREG;
+}
+
+#endif
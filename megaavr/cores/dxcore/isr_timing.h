@@ -0,0 +1,137 @@
+/* isr_timing.h - optional instrumentation of the core's own interrupts
+ * This is part of DxCore. Open source software (LGPL 2.1) see License.md for more info.
+ *
+ * Build with CORE_ISR_TIMING defined (for the whole build, for example in platform.local.txt - defining it in the
+ * sketch is not enough) and a type B timer is left running at CLK_PER; each instrumented ISR reads its count as the
+ * first thing it does and again as the last thing before reti, and the difference goes into a record of the
+ * fewest, most and total clocks, and the number of times it ran. isrTimingGet() reads one out.
+ * The timer is the first of TCB4, TCB3, TCB2, TCB1 and TCB0 that isn't the millis timer or the one the Servo library
+ * would use, or defined with ISR_TIMING_TCB=n. If that ends up being Servo's TCB anyway (picked by hand, or a part
+ * with two TCBs and millis on the other), Servo will #error when it's used. Without CORE_ISR_TIMING, none of this
+ * exists and every macro here expands to nothing.
+ *
+ * The ISRs are assumed not to interrupt each other - the start time of the running one is kept in one place - so
+ * none of them may be made the level 1 (priority) interrupt while this is in use.
+ */
+
+#ifndef ISR_TIMING_H
+#define ISR_TIMING_H
+
+#define ISR_TIMING_MILLIS           0
+#define ISR_TIMING_ATTACH           1 // attachInterrupt(), all ports together
+#define ISR_TIMING_SERVO            2
+#define ISR_TIMING_USART_RXC(n)     (3 + 2 * (n))
+#define ISR_TIMING_USART_DRE(n)     (4 + 2 * (n))
+#define ISR_TIMING_COUNT            15
+
+#if defined(CORE_ISR_TIMING)
+  // The TCB that Servo takes, worked out the same way as in ServoTimers.h
+  #if   defined(SERVO_USE_TIMERB4)
+    #define _ISR_TIMING_SERVO_TCB 4
+  #elif defined(SERVO_USE_TIMERB3)
+    #define _ISR_TIMING_SERVO_TCB 3
+  #elif defined(SERVO_USE_TIMERB2)
+    #define _ISR_TIMING_SERVO_TCB 2
+  #elif defined(SERVO_USE_TIMERB1)
+    #define _ISR_TIMING_SERVO_TCB 1
+  #elif defined(SERVO_USE_TIMERB0)
+    #define _ISR_TIMING_SERVO_TCB 0
+  #elif defined(TCB3) && !defined(MILLIS_USE_TIMERB3) && _AVR_PINCOUNT > 32
+    #define _ISR_TIMING_SERVO_TCB 3
+  #elif defined(TCB1) && !defined(MILLIS_USE_TIMERB1)
+    #define _ISR_TIMING_SERVO_TCB 1
+  #else
+    #define _ISR_TIMING_SERVO_TCB 0
+  #endif
+  #if !defined(ISR_TIMING_TCB)
+    #if   defined(TCB4) && !defined(MILLIS_USE_TIMERB4) && _ISR_TIMING_SERVO_TCB != 4
+      #define ISR_TIMING_TCB 4
+    #elif defined(TCB3) && !defined(MILLIS_USE_TIMERB3) && _ISR_TIMING_SERVO_TCB != 3
+      #define ISR_TIMING_TCB 3
+    #elif defined(TCB2) && !defined(MILLIS_USE_TIMERB2) && _ISR_TIMING_SERVO_TCB != 2
+      #define ISR_TIMING_TCB 2
+    #elif defined(TCB1) && !defined(MILLIS_USE_TIMERB1) && _ISR_TIMING_SERVO_TCB != 1
+      #define ISR_TIMING_TCB 1
+    #elif !defined(MILLIS_USE_TIMERB0) && _ISR_TIMING_SERVO_TCB != 0
+      #define ISR_TIMING_TCB 0
+    // Only two TCBs, and the other one is millis: share with Servo, which will #error if it's actually used.
+    #elif defined(TCB1) && !defined(MILLIS_USE_TIMERB1)
+      #define ISR_TIMING_TCB 1
+    #elif !defined(MILLIS_USE_TIMERB0)
+      #define ISR_TIMING_TCB 0
+    #else
+      #error "CORE_ISR_TIMING needs a type B timer that isn't used for millis, and there isn't one."
+    #endif
+  #endif
+  #if (ISR_TIMING_TCB == 0 && defined(MILLIS_USE_TIMERB0)) || (ISR_TIMING_TCB == 1 && defined(MILLIS_USE_TIMERB1)) || \
+      (ISR_TIMING_TCB == 2 && defined(MILLIS_USE_TIMERB2)) || (ISR_TIMING_TCB == 3 && defined(MILLIS_USE_TIMERB3)) || \
+      (ISR_TIMING_TCB == 4 && defined(MILLIS_USE_TIMERB4))
+    #error "ISR_TIMING_TCB is the millis timer - pick another one."
+  #endif
+
+  #define _ISR_TIMING_STR2(x)       #x
+  #define _ISR_TIMING_STR(x)        _ISR_TIMING_STR2(x)
+  #define _ISR_TIMING_TIMER         (*(TCB_t *)(0x0B00 + 0x10 * ISR_TIMING_TCB))
+  // all TCBs are at 0x0Bn0, and CNT is at offset 10. The assembler does the arithmetic.
+  #define _ISR_TIMING_CNTL          "(0x0B0A + 0x10 * " _ISR_TIMING_STR(ISR_TIMING_TCB) ")"
+  #define _ISR_TIMING_CNTH          "(0x0B0B + 0x10 * " _ISR_TIMING_STR(ISR_TIMING_TCB) ")"
+  #if PROGMEM_SIZE > 8192
+    #define _ISR_TIMING_CALL        "call _isrTimingExit"  "\n\t"
+  #else
+    #define _ISR_TIMING_CALL        "rcall _isrTimingExit" "\n\t"
+  #endif
+
+  #ifdef __cplusplus
+  extern "C" {
+  #endif
+
+  typedef struct {
+    uint16_t min;   // fewest clocks between entry and exit - meaningless if count is 0
+    uint16_t max;   // most clocks
+    uint32_t total; // sum over all the times it ran, for the average
+    uint32_t count; // number of times it ran
+  } isr_timing_t;
+
+  extern volatile uint16_t _isr_timing_start;
+  extern volatile uint8_t  _isr_timing_id;
+  void _isrTimingEnd(uint16_t now);
+  void _isrTimingExit();
+  void init_isr_timing();
+
+  /* Copy the record for one of the ISR_TIMING_ numbers, with interrupts off so it's consistent */
+  void isrTimingGet(uint8_t id, isr_timing_t *dest);
+  /* Clear all the records */
+  void isrTimingReset();
+
+  #ifdef __cplusplus
+  }
+  #endif
+
+  /* For C ISRs - at the very start and very end of the body. The compiler's prologue and epilogue are outside it. */
+  #define ISR_TIMING_ENTER(id)      do {_isr_timing_start = _ISR_TIMING_TIMER.CNT; _isr_timing_id = (id);} while (0)
+  #define ISR_TIMING_EXIT()         _isrTimingEnd(_ISR_TIMING_TIMER.CNT)
+
+  /* For naked ISRs in assembly. ENTER goes first, before anything is pushed, and EXIT goes immediately before the
+   * reti, after everything has been popped. Both leave every register and SREG as they found them. EXIT is a call to
+   * _isrTimingExit() in isr_timing.c, which reads the timer and then saves what it needs to call _isrTimingEnd();
+   * it's a call rather than inline so that it doesn't push branches in the ISRs out of range. */
+  #define ISR_TIMING_ENTER_ASM(id)                        \
+    "push       r24"                            "\n\t"    \
+    "push       r25"                            "\n\t"    \
+    "lds        r24, " _ISR_TIMING_CNTL         "\n\t"    \
+    "lds        r25, " _ISR_TIMING_CNTH         "\n\t"    \
+    "sts        _isr_timing_start,     r24"     "\n\t"    \
+    "sts        _isr_timing_start + 1, r25"     "\n\t"    \
+    "ldi        r24, " _ISR_TIMING_STR(id)      "\n\t"    \
+    "sts        _isr_timing_id,        r24"     "\n\t"    \
+    "pop        r25"                            "\n\t"    \
+    "pop        r24"                            "\n\t"
+  #define ISR_TIMING_EXIT_ASM       _ISR_TIMING_CALL
+#else
+  #define ISR_TIMING_ENTER(id)
+  #define ISR_TIMING_EXIT()
+  #define ISR_TIMING_ENTER_ASM(id)  ""
+  #define ISR_TIMING_EXIT_ASM       ""
+#endif
+
+#endif
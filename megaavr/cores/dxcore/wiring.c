@@ -122,6 +122,7 @@ void init_timers();
   // Now for the ISRs. This gets a little bit more interesting now...
   #if defined (MILLIS_USE_TIMERRTC)
     ISR(MILLIS_VECTOR) {
+      ISR_TIMING_ENTER(ISR_TIMING_MILLIS);
       // if RTC is used as timer, we only increment the overflow count
       // Overflow count isn't used for TCB's
       // both are needed for TCA and TCD.
@@ -129,10 +130,12 @@ void init_timers();
         timingStruct.timer_overflow_count++;
       }
       RTC.INTFLAGS = RTC_OVF_bm | RTC_CMP_bm; // clear flag
+      ISR_TIMING_EXIT();
     }
   #elif !defined(MILLIS_USE_TIMERNONE)
     ISR(MILLIS_VECTOR, ISR_NAKED) {
       __asm__ __volatile__(
+      ISR_TIMING_ENTER_ASM(ISR_TIMING_MILLIS)    // nothing unless built with CORE_ISR_TIMING
       "push       r30"          "\n\t" // First we make room for the pointer to timingStruct by pushing the Z registers
       "push       r31"          "\n\t" //
       ::);
@@ -164,6 +167,7 @@ void init_timers();
       "pop        r24"            "\n\t"
       "pop        r31"            "\n\t"
       "pop        r30"            "\n\t" // 6 more clocks popping registers in reverse order.
+      ISR_TIMING_EXIT_ASM
       "reti"                      "\n\t" // and 4 clocks for reti - total 12/13 + 16 + 2 + 1 + 6 + 4 = 41/42 clocks total, and 7+16+3+6 = 32 words, vs 60-61 clocks and 40 words
       :: "z" (&timingStruct.timer_millis),
          [CLRFL] "M" (_timerS.intClear),
@@ -282,6 +286,7 @@ void init_timers();
       "pop        r24"            "\n\t"
       "pop        r31"            "\n\t"
       "pop        r30"            "\n\t"
+      ISR_TIMING_EXIT_ASM
       "reti"                      "\n\t" // total 77 - 79 clocks total, and 58 words, vs 104-112 clocks and 84 words
       :: "z" (&timingStruct),            // we are changing the value of "Z", so to be strictly correct, this must be declared input output - though in this case it doesn't matter
         [LFRINC] "M" (((0x0000 - FRACT_INC)    & 0xFF)),
@@ -1518,6 +1523,9 @@ void init() {
   #endif
   init_clock();
   init_timers();
+  #if defined(CORE_ISR_TIMING)
+    init_isr_timing();
+  #endif
   #if defined(ADC0)
     init_ADC0();
   #endif
@@ -624,6 +624,13 @@ void analogReference(uint8_t mode) {
   }
 }
 
+/* True if the ADC has been handed over to one of the background modes (event triggered or free running
+ * conversions, or a scan driven by the RESRDY interrupt), in which case analogRead() and friends would steal
+ * or corrupt its results */
+static inline __attribute__((always_inline)) bool _analogInBackground() {
+  return (ADC0.EVCTRL & ADC_STARTEI_bm) || (ADC0.CTRLA & ADC_FREERUN_bm) || (ADC0.INTCTRL & ADC_RESRDY_bm);
+}
+
 int16_t analogRead(uint8_t pin) {
   check_valid_analog_pin(pin);
   if (pin < 0x80) {
@@ -632,6 +639,9 @@ int16_t analogRead(uint8_t pin) {
       return ADC_ERROR_BAD_PIN_OR_CHANNEL;
     }
   }
+  if (_analogInBackground()) {
+    return ADC_ERROR_BUSY;
+  }
   /* Select channel */
   ADC0.MUXPOS = ((pin & 0x7F) << ADC_MUXPOS_gp);
   /* Reference should be already set up */
@@ -717,7 +727,7 @@ int32_t _analogReadEnh(uint8_t pin, uint8_t neg, uint8_t res, __attribute__ ((un
           and try to use them with analogReadEnh(), instead of just returning whatever we get from reading the bogus channel */
     return ADC_ENH_ERROR_BAD_PIN_OR_CHANNEL;
   }
-  if (ADC0.COMMAND & ADC_STCONV_bm) {
+  if ((ADC0.COMMAND & ADC_STCONV_bm) || _analogInBackground()) {
     return ADC_ENH_ERROR_BUSY;
   /*  Doing the busy check up here so that if we are doing differential read, we
       find out before calculating MUXNEG, which we can now assign as soon as calculated..
@@ -896,6 +906,127 @@ int16_t analogClockSpeed(int16_t frequency, uint8_t options) {
   return pgm_read_word_near(&adc_prescale_to_clkadc[ADC0.CTRLC & ADC_PRESC_gm]);
 }
 
+/*
+Conversion triggers for the background ADC modes. The timer is set up to generate an event rate times a second,
+and that is routed to the ADC's start input through the highest numbered free event channel - the same place the
+Event library looks first, and a channel is considered free the same way the Event library does: if no generator
+is assigned to it. Returns 0 or one of the ADC_SAMPLE_ERROR_ codes. Only one trigger can be active at a time,
+since there is only one ADC start user.
+*/
+#if defined(EVSYS_CHANNEL9)
+  #define ADC_EVSYS_CHANNELS 10
+#elif defined(EVSYS_CHANNEL7)
+  #define ADC_EVSYS_CHANNELS 8
+#else
+  #define ADC_EVSYS_CHANNELS 6
+#endif
+#if defined(TCB4)
+  #define ADC_TRIGGER_TCBS 5
+#elif defined(TCB3)
+  #define ADC_TRIGGER_TCBS 4
+#elif defined(TCB2)
+  #define ADC_TRIGGER_TCBS 3
+#else
+  #define ADC_TRIGGER_TCBS 2
+#endif
+
+static uint8_t _analog_trigger_timer;
+
+int8_t _analogTriggerStart(uint8_t timer, uint16_t rate) {
+  if (rate == 0) {
+    return ADC_SAMPLE_ERROR_TIMER;
+  }
+  if (EVSYS.USERADC0START) {
+    return ADC_SAMPLE_ERROR_BUSY;
+  }
+  volatile uint8_t *channel = &EVSYS.CHANNEL0;
+  uint8_t ch = ADC_EVSYS_CHANNELS;
+  do {
+    if (ch == 0) {
+      return ADC_SAMPLE_ERROR_NO_CHANNEL;
+    }
+    ch--;
+  } while (channel[ch]);
+  uint8_t generator;
+  if (timer == ADC_TIMER_RTC) {
+    #if defined(MILLIS_USE_TIMERRTC)
+      return ADC_SAMPLE_ERROR_TIMER;
+    #else
+      // RTC overflow, clocked from the internal 32.768 kHz oscillator.
+      if (rate > 16384) {
+        return ADC_SAMPLE_ERROR_TIMER;
+      }
+      while (RTC.STATUS);
+      RTC.CTRLA = 0;
+      while (RTC.STATUS);
+      RTC.CLKSEL = RTC_CLKSEL_OSC32K_gc;
+      RTC.CNT = 0;
+      RTC.PER = (32768UL / rate) - 1;
+      RTC.CTRLA = RTC_PRESCALER_DIV1_gc | RTC_RUNSTDBY_bm | RTC_RTCEN_bm; // keep pacing the ADC in standby sleep
+      generator = EVSYS_CHANNEL0_RTC_OVF_gc;
+    #endif
+  } else {
+    if (timer >= ADC_TRIGGER_TCBS) {
+      return ADC_SAMPLE_ERROR_TIMER;
+    }
+    #if defined(MILLIS_USE_TIMERB0)
+      if (timer == 0) return ADC_SAMPLE_ERROR_TIMER;
+    #elif defined(MILLIS_USE_TIMERB1)
+      if (timer == 1) return ADC_SAMPLE_ERROR_TIMER;
+    #elif defined(MILLIS_USE_TIMERB2)
+      if (timer == 2) return ADC_SAMPLE_ERROR_TIMER;
+    #elif defined(MILLIS_USE_TIMERB3)
+      if (timer == 3) return ADC_SAMPLE_ERROR_TIMER;
+    #elif defined(MILLIS_USE_TIMERB4)
+      if (timer == 4) return ADC_SAMPLE_ERROR_TIMER;
+    #endif
+    // Periodic interrupt mode (with the interrupt off); it generates a CAPT event every time it reaches CCMP.
+    TCB_t *tcb = &TCB0 + timer;
+    uint32_t ticks = F_CPU / rate;
+    uint8_t clksel = TCB_CLKSEL_DIV1_gc;
+    if (ticks > 0x10000UL) {
+      ticks >>= 1;
+      clksel = TCB_CLKSEL_DIV2_gc;
+      if (ticks > 0x10000UL) {
+        return ADC_SAMPLE_ERROR_TIMER;
+      }
+    }
+    tcb->CTRLA   = 0;
+    tcb->CTRLB   = TCB_CNTMODE_INT_gc;
+    tcb->INTCTRL = 0;
+    tcb->EVCTRL  = 0;
+    tcb->CNT     = 0;
+    tcb->CCMP    = ticks - 1;
+    tcb->CTRLA   = clksel | TCB_ENABLE_bm;
+    generator = EVSYS_CHANNEL0_TCB0_CAPT_gc + (timer << 1);
+  }
+  _analog_trigger_timer = timer;
+  channel[ch] = generator;
+  EVSYS.USERADC0START = ch + 1;
+  ADC0.EVCTRL = ADC_STARTEI_bm;
+  return 0;
+}
+
+void _analogTriggerStop() {
+  uint8_t user = EVSYS.USERADC0START;
+  if (!user) {
+    return;
+  }
+  ADC0.EVCTRL = 0;
+  EVSYS.USERADC0START = 0;
+  (&EVSYS.CHANNEL0)[user - 1] = 0;
+  if (_analog_trigger_timer == ADC_TIMER_RTC) {
+    #if !defined(MILLIS_USE_TIMERRTC)
+      while (RTC.STATUS);
+      RTC.CTRLA = 0;
+    #endif
+  } else {
+    (&TCB0 + _analog_trigger_timer)->CTRLA = 0;
+  }
+  // let a conversion that was already started finish, so it doesn't leave a stale result behind.
+  while (ADC0.COMMAND & ADC_STCONV_bm);
+}
+
 #endif
 /* From here on down is PWM stuff */
 
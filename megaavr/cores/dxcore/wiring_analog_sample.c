@@ -0,0 +1,131 @@
+/*  OBLIGATORY LEGAL BOILERPLATE
+ This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License as published by the Free Software Foundation;
+ either version 2.1 of the License, or (at your option) any later version. This library is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ See the GNU Lesser General Public License for more details. You should have received a copy of the GNU Lesser General Public License along with this library;
+ if not, write to the Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*//*
+  wiring_analog_sample.c - background ADC sampling into a ring buffer.
+  Part of DxCore.
+
+  A type B timer (or the RTC) generates an event at the sample rate, which starts a conversion through the event
+  system, so the sampling instants have no jitter from interrupt latency or whatever the sketch is doing. The
+  RESRDY interrupt just moves each result into the user's buffer. This is in its own file because it defines the
+  ADC0_RESRDY_vect ISR, which would otherwise be pulled into every sketch that uses analogRead(), and prevent
+  people from writing their own.
+*/
+
+#include "wiring_private.h"
+#include "pins_arduino.h"
+#include "Arduino.h"
+
+#if !defined(__AVR_EA__)
+
+typedef struct {
+  int16_t *buffer;
+  uint16_t length;
+  volatile uint16_t head;     // written by the ISR
+  volatile uint16_t tail;     // written by analogSampleRead()
+  volatile uint16_t overruns; // samples dropped because the buffer was full
+} analog_sample_t;
+
+static analog_sample_t _analog_sample;
+
+/* Start sampling pin (single ended, at the current resolution, reference and sample duration) rate times a second.
+ * The buffer holds length - 1 samples. Returns 0, or an ADC_SAMPLE_ERROR_ code. */
+int8_t analogSampleStart(uint8_t pin, int16_t *buffer, uint16_t length, uint16_t rate, uint8_t timer) {
+  if (pin < 0x80) {
+    pin = digitalPinToAnalogInput(pin);
+  } else {
+    pin &= 0x7F;
+  }
+  if (pin > 0x4B || (pin > ADC_MAXIMUM_PIN_CHANNEL && pin < 0x40) || length < 2) {
+    return ADC_SAMPLE_ERROR_BAD_PIN;
+  }
+  if ((ADC0.INTCTRL & ADC_RESRDY_bm) || (ADC0.EVCTRL & ADC_STARTEI_bm) || (ADC0.CTRLA & ADC_FREERUN_bm)) {
+    return ADC_SAMPLE_ERROR_BUSY;
+  }
+  _analog_sample.buffer   = buffer;
+  _analog_sample.length   = length;
+  _analog_sample.head     = 0;
+  _analog_sample.tail     = 0;
+  _analog_sample.overruns = 0;
+  ADC0.MUXPOS   = pin;
+  ADC0.CTRLA   &= ~ADC_CONVMODE_bm;
+  ADC0.INTFLAGS = ADC_RESRDY_bm;
+  ADC0.INTCTRL |= ADC_RESRDY_bm;
+  int8_t err = _analogTriggerStart(timer, rate);
+  if (err) {
+    ADC0.INTCTRL &= ~ADC_RESRDY_bm;
+  }
+  return err;
+}
+
+void analogSampleStop() {
+  if (!(ADC0.INTCTRL & ADC_RESRDY_bm)) {
+    return;
+  }
+  _analogTriggerStop();
+  ADC0.INTCTRL &= ~ADC_RESRDY_bm;
+  ADC0.INTFLAGS = ADC_RESRDY_bm;
+  #if (defined(ERRATA_ADC_PIN_DISABLE) && ERRATA_ADC_PIN_DISABLE != 0)
+    ADC0.MUXPOS = 0x40;
+  #endif
+}
+
+uint16_t analogSampleAvailable() {
+  uint8_t oldSREG = SREG;
+  cli();
+  uint16_t head = _analog_sample.head;
+  SREG = oldSREG;
+  uint16_t tail = _analog_sample.tail;
+  if (head >= tail) {
+    return head - tail;
+  }
+  return _analog_sample.length - tail + head;
+}
+
+/* Copy up to count samples, oldest first, into dest. Returns the number copied. */
+uint16_t analogSampleRead(int16_t *dest, uint16_t count) {
+  uint16_t available = analogSampleAvailable();
+  if (count > available) {
+    count = available;
+  }
+  uint16_t tail = _analog_sample.tail;
+  for (uint16_t i = 0; i < count; i++) {
+    dest[i] = _analog_sample.buffer[tail];
+    if (++tail == _analog_sample.length) {
+      tail = 0;
+    }
+  }
+  uint8_t oldSREG = SREG;
+  cli();
+  _analog_sample.tail = tail;
+  SREG = oldSREG;
+  return count;
+}
+
+uint16_t analogSampleOverruns() {
+  uint8_t oldSREG = SREG;
+  cli();
+  uint16_t overruns = _analog_sample.overruns;
+  SREG = oldSREG;
+  return overruns;
+}
+
+ISR(ADC0_RESRDY_vect) {
+  int16_t result = ADC0.RES; // clears the flag
+  uint16_t head = _analog_sample.head;
+  uint16_t next = head + 1;
+  if (next == _analog_sample.length) {
+    next = 0;
+  }
+  if (next != _analog_sample.tail) {
+    _analog_sample.buffer[head] = result;
+    _analog_sample.head = next;
+  } else {
+    _analog_sample.overruns++;
+  }
+}
+
+#endif
@@ -0,0 +1,184 @@
+/*  OBLIGATORY LEGAL BOILERPLATE
+ This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License as published by the Free Software Foundation;
+ either version 2.1 of the License, or (at your option) any later version. This library is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ See the GNU Lesser General Public License for more details. You should have received a copy of the GNU Lesser General Public License along with this library;
+ if not, write to the Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*//*
+  wiring_analog_scan.c - background scan of a list of ADC channels.
+  Part of DxCore.
+
+  The RESRDY interrupt stores each result, sets up the next entry in the list and starts its conversion. The
+  settings of each entry are checked and converted to register values once, in analogScanStart(), and the ISR
+  only writes the registers that differ from the previous entry - with a list of single ended reads at the same
+  settings, that's just MUXPOS. Results go into one of two frames; when a frame is complete it's handed to the
+  sketch, and the next one is written to the other frame. Like the sampler, this has its own file because it
+  defines ADC0_RESRDY_vect - which also means that the two can't be used in the same sketch.
+*/
+
+#include "wiring_private.h"
+#include "pins_arduino.h"
+#include "Arduino.h"
+
+#if !defined(__AVR_EA__)
+
+typedef struct {
+  analog_scan_t *table;
+  int16_t *writing;           // frame the ISR is filling
+  int16_t *volatile ready;    // completed frame not yet picked up, or NULL
+  int16_t *volatile held;     // frame last returned by analogScanGetFrame(), or NULL
+  int16_t *frames;            // the two frames, count entries each
+  uint8_t count;
+  uint8_t index;              // entry being converted
+  uint8_t continuous;
+  volatile uint8_t running;   // a frame is in progress
+  uint8_t ctrla;              // settings to restore when the scan is stopped
+  uint8_t ctrlb;
+  uint8_t sampctrl;
+} analog_scan_state_t;
+
+static analog_scan_state_t _analog_scan;
+
+/* Write the registers that differ between entry prev and entry next, then start the conversion of next. */
+static inline __attribute__((always_inline)) void _analogScanNext(const analog_scan_t *prev, const analog_scan_t *next) {
+  if (next->pos != prev->pos) {
+    ADC0.MUXPOS = next->pos & 0x7F;
+  }
+  if (next->neg != prev->neg) {
+    if (next->neg == ADC_SINGLE_ENDED) {
+      ADC0.CTRLA &= ~ADC_CONVMODE_bm;
+    } else {
+      ADC0.MUXNEG = next->neg & 0x7F;
+      if (prev->neg == ADC_SINGLE_ENDED) {
+        ADC0.CTRLA |= ADC_CONVMODE_bm;
+      }
+    }
+  }
+  if (next->accumulate != prev->accumulate) {
+    ADC0.CTRLB = next->accumulate & ADC_SAMPNUM_gm;
+  }
+  if (next->sampleDuration != prev->sampleDuration) {
+    ADC0.SAMPCTRL = next->sampleDuration;
+  }
+  ADC0.COMMAND = ADC_STCONV_bm;
+}
+
+/* Check the table and convert pins to ADC_CH() form in place, then take over the ADC. results must have room for
+ * 2 * count values. Returns 0, ADC_SAMPLE_ERROR_BAD_PIN if an entry is invalid or ADC_SAMPLE_ERROR_BUSY. */
+int8_t analogScanStart(analog_scan_t *table, uint8_t count, int16_t *results, bool continuous) {
+  if ((ADC0.INTCTRL & ADC_RESRDY_bm) || (ADC0.EVCTRL & ADC_STARTEI_bm) || (ADC0.CTRLA & ADC_FREERUN_bm) || (ADC0.COMMAND & ADC_STCONV_bm)) {
+    return ADC_SAMPLE_ERROR_BUSY;
+  }
+  if (count == 0) {
+    return ADC_SAMPLE_ERROR_BAD_PIN;
+  }
+  for (uint8_t i = 0; i < count; i++) {
+    analog_scan_t *e = table + i;
+    uint8_t pos = e->pos < 0x80 ? digitalPinToAnalogInput(e->pos) : (e->pos & 0x7F);
+    if (pos > 0x4B || (pos > ADC_MAXIMUM_PIN_CHANNEL && pos < 0x40)) {
+      return ADC_SAMPLE_ERROR_BAD_PIN;
+    }
+    e->pos = ADC_CH(pos);
+    if (e->neg != ADC_SINGLE_ENDED) {
+      uint8_t neg = e->neg < 0x80 ? digitalPinToAnalogInput(e->neg) : (e->neg & 0x7F);
+      if (neg > ADC_MAXIMUM_NEGATIVE_PIN && neg != 0x40 && neg != 0x48) {
+        return ADC_SAMPLE_ERROR_BAD_PIN;
+      }
+      e->neg = ADC_CH(neg);
+    }
+    if (e->accumulate && (e->accumulate < ADC_ACC2 || e->accumulate > ADC_ACC128)) {
+      return ADC_SAMPLE_ERROR_BAD_PIN;
+    }
+  }
+  _analog_scan.table      = table;
+  _analog_scan.count      = count;
+  _analog_scan.frames     = results;
+  _analog_scan.writing    = results;
+  _analog_scan.ready      = NULL;
+  _analog_scan.held       = NULL;
+  _analog_scan.index      = 0;
+  _analog_scan.continuous = continuous;
+  _analog_scan.running    = 0;
+  _analog_scan.ctrla      = ADC0.CTRLA;
+  _analog_scan.ctrlb      = ADC0.CTRLB;
+  _analog_scan.sampctrl   = ADC0.SAMPCTRL;
+  // The ISR assumes the registers hold the settings of the last entry between frames, so put them there.
+  const analog_scan_t *last = table + count - 1;
+  ADC0.MUXPOS   = last->pos & 0x7F;
+  if (last->neg == ADC_SINGLE_ENDED) {
+    ADC0.CTRLA &= ~ADC_CONVMODE_bm;
+  } else {
+    ADC0.MUXNEG = last->neg & 0x7F;
+    ADC0.CTRLA |= ADC_CONVMODE_bm;
+  }
+  ADC0.CTRLB    = last->accumulate & ADC_SAMPNUM_gm;
+  ADC0.SAMPCTRL = last->sampleDuration;
+  ADC0.INTFLAGS = ADC_RESRDY_bm;
+  ADC0.INTCTRL |= ADC_RESRDY_bm;
+  if (continuous) {
+    analogScanTrigger();
+  }
+  return 0;
+}
+
+/* Start a frame. Returns false if the scan isn't started or a frame is already in progress. */
+bool analogScanTrigger() {
+  if (!(ADC0.INTCTRL & ADC_RESRDY_bm) || _analog_scan.running) {
+    return false;
+  }
+  _analog_scan.running = 1;
+  _analogScanNext(_analog_scan.table + _analog_scan.count - 1, _analog_scan.table);
+  return true;
+}
+
+/* Returns the newest completed frame, or NULL if none has been completed since the last call. The frame stays
+ * valid until the next call; a frame that finishes while the other one is held is dropped. */
+const int16_t *analogScanGetFrame() {
+  uint8_t oldSREG = SREG;
+  cli();
+  int16_t *frame = _analog_scan.ready;
+  _analog_scan.held = frame;
+  _analog_scan.ready = NULL;
+  SREG = oldSREG;
+  return frame;
+}
+
+void analogScanStop() {
+  if (!(ADC0.INTCTRL & ADC_RESRDY_bm)) {
+    return;
+  }
+  ADC0.INTCTRL &= ~ADC_RESRDY_bm;
+  while (ADC0.COMMAND & ADC_STCONV_bm);
+  ADC0.INTFLAGS = ADC_RESRDY_bm;
+  _analog_scan.running = 0;
+  ADC0.CTRLA    = _analog_scan.ctrla;
+  ADC0.CTRLB    = _analog_scan.ctrlb;
+  ADC0.SAMPCTRL = _analog_scan.sampctrl;
+  #if (defined(ERRATA_ADC_PIN_DISABLE) && ERRATA_ADC_PIN_DISABLE != 0)
+    ADC0.MUXPOS = 0x40;
+  #endif
+}
+
+ISR(ADC0_RESRDY_vect) {
+  uint8_t i = _analog_scan.index;
+  _analog_scan.writing[i] = ADC0.RES; // clears the flag
+  const analog_scan_t *prev = _analog_scan.table + i;
+  if (++i == _analog_scan.count) {
+    // frame complete - hand it over, unless the other frame is still held by the sketch, then we reuse this one.
+    int16_t *other = _analog_scan.writing == _analog_scan.frames ? _analog_scan.frames + i : _analog_scan.frames;
+    if (_analog_scan.held != other) {
+      _analog_scan.ready = _analog_scan.writing;
+      _analog_scan.writing = other;
+    }
+    i = 0;
+    if (!_analog_scan.continuous) {
+      _analog_scan.index = 0;
+      _analog_scan.running = 0;
+      return;
+    }
+  }
+  _analog_scan.index = i;
+  _analogScanNext(prev, _analog_scan.table + i);
+}
+
+#endif
@@ -0,0 +1,103 @@
+/*  OBLIGATORY LEGAL BOILERPLATE
+ This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License as published by the Free Software Foundation;
+ either version 2.1 of the License, or (at your option) any later version. This library is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ See the GNU Lesser General Public License for more details. You should have received a copy of the GNU Lesser General Public License along with this library;
+ if not, write to the Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*//*
+  wiring_analog_window.c - watch an analog input with the ADC window comparator.
+  Part of DxCore.
+
+  The ADC converts in the background - free running, or started by a timer through the event system - and the
+  window comparator only raises its interrupt when a result matches the mode in CTRLE. The hardware can only
+  tell us "this result is inside" or "this result is outside", not "this result is different from the last one",
+  so every time the interrupt fires we flip the mode between inside and outside. That way the CPU only hears from
+  the ADC when the input crosses into or out of the window, rather than for every sample that's on one side.
+  The ADC0_WCMP_vect ISR is why this is in its own file.
+*/
+
+#include "wiring_private.h"
+#include "pins_arduino.h"
+#include "Arduino.h"
+
+#if !defined(__AVR_EA__)
+
+typedef struct {
+  void (*callback)(bool inside, int16_t value);
+  uint8_t events;  // ADC_WINDOW_ENTER and/or ADC_WINDOW_LEAVE
+  uint8_t timer;   // 0xFF for free running
+} analog_window_t;
+
+static analog_window_t _analog_window;
+
+/* Watch pin, calling callback when a reading enters or leaves the window low..high (inclusive, in the units
+ * analogRead() returns at the current resolution). With rate == 0 the ADC runs free, otherwise the timer starts
+ * conversions rate times a second as for analogSampleStart(). Returns 0 or an ADC_SAMPLE_ERROR_ code. */
+int8_t analogWindowStart(uint8_t pin, int16_t low, int16_t high, uint8_t events, void (*callback)(bool inside, int16_t value), uint16_t rate, uint8_t timer) {
+  if (pin < 0x80) {
+    pin = digitalPinToAnalogInput(pin);
+  } else {
+    pin &= 0x7F;
+  }
+  if (pin > 0x4B || (pin > ADC_MAXIMUM_PIN_CHANNEL && pin < 0x40) || !(events & ADC_WINDOW_BOTH)) {
+    return ADC_SAMPLE_ERROR_BAD_PIN;
+  }
+  if ((ADC0.INTCTRL & (ADC_RESRDY_bm | ADC_WCMP_bm)) || (ADC0.EVCTRL & ADC_STARTEI_bm) || (ADC0.CTRLA & ADC_FREERUN_bm) || (ADC0.COMMAND & ADC_STCONV_bm)) {
+    return ADC_SAMPLE_ERROR_BUSY;
+  }
+  _analog_window.callback = callback;
+  _analog_window.events   = events;
+  ADC0.MUXPOS   = pin;
+  ADC0.CTRLA   &= ~ADC_CONVMODE_bm;
+  ADC0.WINLT    = low;
+  ADC0.WINHT    = high;
+  // Start out looking for the first kind of crossing asked for; if the input is already there, that fires at once.
+  ADC0.CTRLE    = (events & ADC_WINDOW_LEAVE) ? ADC_WINCM_OUTSIDE_gc : ADC_WINCM_INSIDE_gc;
+  ADC0.INTFLAGS = ADC_WCMP_bm;
+  ADC0.INTCTRL |= ADC_WCMP_bm;
+  if (rate) {
+    int8_t err = _analogTriggerStart(timer, rate);
+    if (err) {
+      ADC0.INTCTRL &= ~ADC_WCMP_bm;
+      ADC0.CTRLE = 0;
+      return err;
+    }
+    _analog_window.timer = timer;
+  } else {
+    _analog_window.timer = 0xFF;
+    ADC0.CTRLA   |= ADC_FREERUN_bm;
+    ADC0.COMMAND  = ADC_STCONV_bm;
+  }
+  return 0;
+}
+
+void analogWindowStop() {
+  if (!(ADC0.INTCTRL & ADC_WCMP_bm)) {
+    return;
+  }
+  if (_analog_window.timer == 0xFF) {
+    ADC0.CTRLA &= ~ADC_FREERUN_bm;
+    while (ADC0.COMMAND & ADC_STCONV_bm);
+  } else {
+    _analogTriggerStop();
+  }
+  ADC0.INTCTRL &= ~ADC_WCMP_bm;
+  ADC0.CTRLE    = 0;
+  ADC0.INTFLAGS = ADC_WCMP_bm | ADC_RESRDY_bm;
+  #if (defined(ERRATA_ADC_PIN_DISABLE) && ERRATA_ADC_PIN_DISABLE != 0)
+    ADC0.MUXPOS = 0x40;
+  #endif
+}
+
+ISR(ADC0_WCMP_vect) {
+  int16_t value = ADC0.RES;
+  ADC0.INTFLAGS = ADC_WCMP_bm;
+  bool inside = (ADC0.CTRLE & ADC_WINCM_gm) == ADC_WINCM_INSIDE_gc;
+  // now wait for it to cross back
+  ADC0.CTRLE = inside ? ADC_WINCM_OUTSIDE_gc : ADC_WINCM_INSIDE_gc;
+  if ((_analog_window.events & (inside ? ADC_WINDOW_ENTER : ADC_WINDOW_LEAVE)) && _analog_window.callback) {
+    _analog_window.callback(inside, value);
+  }
+}
+
+#endif
@@ -76,18 +76,19 @@ inline __attribute__((always_inline)) void pinMode(uint8_t pin, uint8_t mode) {
   _pinMode(pin, mode);
 }
 void _pinMode(uint8_t pin, uint8_t mode) {
-  uint8_t bit_mask = digitalPinToBitMask(pin);
-  if ((bit_mask == NOT_A_PIN) || (mode > INPUT_PULLUP)) {
+  if (pin >= NUM_TOTAL_PINS || mode > INPUT_PULLUP) {
     return;                             /* ignore invalid pins passed at runtime */
   }
-  PORT_t *port = digitalPinToPortStruct(pin);
-  // if (port == NULL) return;           /* skip this test; if bit_mask isn't NOT_A_PIN, port won't be null - if it is, pins_arduino.h contains errors and we can't expect any digital I/O to work correctly.
+  const pin_descriptor_t *desc = &digital_pin_to_descriptor[pin];
+  uint8_t bit_mask = desc->bit_mask;
+  if (bit_mask == NOT_A_PIN) {
+    return;
+  }
+  PORT_t *port = _pinDescToPortStruct(desc);
   if (mode == OUTPUT) {
     port->DIRSET = bit_mask;            /* Configure direction as output and done*/
   } else {                              /* mode == INPUT or INPUT_PULLUP - more complicated */
-                                        /* Calculate where pin control register is */
-    uint8_t bit_pos = digitalPinToBitPosition(pin);
-    volatile uint8_t *pin_ctrl = getPINnCTRLregister(port, bit_pos);
+    volatile uint8_t *pin_ctrl = _pinDescToPINnCTRL(desc);
     uint8_t status = SREG;              /* Save state */
     cli();                              /* Interrupts off for PINnCTRL stuff */
     port->DIRCLR = bit_mask;            /* Configure direction as input */
@@ -208,14 +209,16 @@ void turnOffPWM(uint8_t pin)
 
 void digitalWrite(uint8_t pin, uint8_t val) {
   check_valid_digital_pin(pin);
-  /* Get bit mask for pin */
-  uint8_t bit_mask = digitalPinToBitMask(pin);
+  if (pin >= NUM_TOTAL_PINS) {
+    return;
+  }
+  /* One lookup gets the bit mask, the port, the PINnCTRL register and whether PWM is possible */
+  const pin_descriptor_t *desc = &digital_pin_to_descriptor[pin];
+  uint8_t bit_mask = desc->bit_mask;
   if (bit_mask == NOT_A_PIN) {
     return;
   }
-
-  /* Get port */
-  PORT_t *port = digitalPinToPortStruct(pin);
+  PORT_t *port = _pinDescToPortStruct(desc);
   /* Set output to value
   This now runs even if port set INPUT in order to emulate
   the behavior of digitalWrite() on classic AVR devices, where
@@ -254,11 +257,7 @@ void digitalWrite(uint8_t pin, uint8_t val) {
       Should we purposely implement this side effect?
     */
 
-    /* Get bit position for getting pin ctrl reg */
-    uint8_t bit_pos = digitalPinToBitPosition(pin);
-
-    /* Calculate where pin control register is */
-    volatile uint8_t *pin_ctrl_reg = getPINnCTRLregister(port, bit_pos);
+    volatile uint8_t *pin_ctrl_reg = _pinDescToPINnCTRL(desc);
 
     /* Save system status and disable interrupts */
     uint8_t status = SREG;
@@ -284,8 +283,11 @@ void digitalWrite(uint8_t pin, uint8_t val) {
    * analogWritten() 255, then digitallyWritten() to HIGH, which
    * would turn it off for the time between turnOffPWM() and
    * PORT->OUTCLR)
-   * Since there's no penalty, why make a glitch we don't have to? */
-  turnOffPWM(pin);
+   * Since there's no penalty, why make a glitch we don't have to?
+   * Most pins can't have PWM at all, and for those we skip the whole thing. */
+  if (desc->pwm) {
+    turnOffPWM(pin);
+  }
 }
 
 inline __attribute__((always_inline)) void digitalWriteFast(uint8_t pin, uint8_t val) {
@@ -319,8 +321,12 @@ inline __attribute__((always_inline)) void digitalWriteFast(uint8_t pin, uint8_t
 
 int8_t digitalRead(uint8_t pin) {
   check_valid_digital_pin(pin);
+  if (pin >= NUM_TOTAL_PINS) {
+    return -1;
+  }
   /* Get bit mask and check valid pin */
-  uint8_t bit_mask = digitalPinToBitMask(pin);
+  const pin_descriptor_t *desc = &digital_pin_to_descriptor[pin];
+  uint8_t bit_mask = desc->bit_mask;
   if (bit_mask == NOT_A_PIN) {
     return -1;
   }
@@ -333,8 +339,7 @@ int8_t digitalRead(uint8_t pin) {
   //
   // turnOffPWM(pin);
 
-  /* Get port and check valid port */
-  PORT_t *port = digitalPinToPortStruct(pin);
+  PORT_t *port = _pinDescToPortStruct(desc);
 
   /* Read pin value from PORTx.IN register */
   if (port->IN & bit_mask) {
@@ -364,10 +369,11 @@ inline __attribute__((always_inline)) int8_t digitalReadFast(uint8_t pin) {
 
 void openDrain(uint8_t pin, uint8_t state) {
   check_valid_digital_pin(pin);
-  uint8_t bit_mask = digitalPinToBitMask(pin);
+  if (pin >= NUM_TOTAL_PINS)  return;
+  const pin_descriptor_t *desc = &digital_pin_to_descriptor[pin];
+  uint8_t bit_mask = desc->bit_mask;
   if (bit_mask == NOT_A_PIN)  return;
-  /* Get port */
-  PORT_t *port = digitalPinToPortStruct(pin);
+  PORT_t *port = _pinDescToPortStruct(desc);
   port->OUTCLR = bit_mask;
   if (state == LOW)
     port->DIRSET = bit_mask;
@@ -375,7 +381,9 @@ void openDrain(uint8_t pin, uint8_t state) {
     port->DIRTGL=bit_mask;
   else // assume FLOATING
     port->DIRCLR=bit_mask;
-  turnOffPWM(pin);
+  if (desc->pwm) {
+    turnOffPWM(pin);
+  }
 }
 
 inline __attribute__((always_inline)) void openDrainFast(uint8_t pin, uint8_t val)
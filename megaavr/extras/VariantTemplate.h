@@ -587,6 +587,58 @@ static const uint8_t A21 = PIN_A21;
   //NOT_ON_TIMER, //  55 PF7 (UPDI)
   };
 
+  /* Generated by extras/development/make_pin_descriptors.py from the tables above - rerun it after changing them. */
+  const pin_descriptor_t digital_pin_to_descriptor[] = {
+    #if CLOCK_SOURCE == 0
+      _PIN_DESC(PA, PIN0_bp, NOT_ON_TIMER), //  0 PA0/XTAL0/CLKIN
+    #else
+      _PIN_DESC_NONE,
+    #endif
+    #if CLOCK_SOURCE == 1
+      _PIN_DESC_NONE,                       //  1 PA1/XTAL1
+    #else
+      _PIN_DESC(PA, PIN1_bp, NOT_ON_TIMER),
+    #endif
+    _PIN_DESC(PA, PIN2_bp, NOT_ON_TIMER),   //  2 PA2/SDA
+    _PIN_DESC(PA, PIN3_bp, NOT_ON_TIMER),   //  3 PA3/SCL
+    _PIN_DESC(PA, PIN4_bp, TIMERD0),        //  4 PA4/MOSI
+    _PIN_DESC(PA, PIN5_bp, TIMERD0),        //  5 PA5/MISO
+    _PIN_DESC(PA, PIN6_bp, TIMERD0),        //  6 PA6/SCK
+    _PIN_DESC(PA, PIN7_bp, TIMERD0),        //  7 PA7/SS/CLKOUT/LED_BUILTIN
+    _PIN_DESC(PB, PIN0_bp, NOT_ON_TIMER),   //  8 PB0/USART3_Tx
+    _PIN_DESC(PB, PIN1_bp, NOT_ON_TIMER),   //  9 PB1/USART3_Rx
+    _PIN_DESC(PB, PIN2_bp, NOT_ON_TIMER),   // 10 PB2
+    _PIN_DESC(PB, PIN3_bp, NOT_ON_TIMER),   // 11 PB3
+    _PIN_DESC(PB, PIN4_bp, NOT_ON_TIMER),   // 12 PB4/(TCB2 PWM)
+    _PIN_DESC(PB, PIN5_bp, NOT_ON_TIMER),   // 13 PB5
+    _PIN_DESC(PC, PIN0_bp, TIMERB2),        // 14 PC0/USART1_Tx
+    _PIN_DESC(PC, PIN1_bp, TIMERB3),        // 15 PC1/USART1_Rx
+    _PIN_DESC(PC, PIN2_bp, NOT_ON_TIMER),   // 16 PC2
+    _PIN_DESC(PC, PIN3_bp, NOT_ON_TIMER),   // 17 PC3
+    _PIN_DESC(PC, PIN4_bp, NOT_ON_TIMER),   // 18 PC4
+    _PIN_DESC(PC, PIN5_bp, NOT_ON_TIMER),   // 19 PC5
+    _PIN_DESC(PC, PIN6_bp, NOT_ON_TIMER),   // 20 PC6
+    _PIN_DESC(PC, PIN7_bp, NOT_ON_TIMER),   // 21 PC7
+    _PIN_DESC(PD, PIN0_bp, NOT_ON_TIMER),   // 22 PD0/AIN0
+    _PIN_DESC(PD, PIN1_bp, NOT_ON_TIMER),   // 23 PD1/AIN1
+    _PIN_DESC(PD, PIN2_bp, NOT_ON_TIMER),   // 24 PD2/AIN2
+    _PIN_DESC(PD, PIN3_bp, NOT_ON_TIMER),   // 25 PD3/AIN3
+    _PIN_DESC(PD, PIN4_bp, NOT_ON_TIMER),   // 26 PD4/AIN4
+    _PIN_DESC(PD, PIN5_bp, NOT_ON_TIMER),   // 27 PD5/AIN5
+    _PIN_DESC(PD, PIN6_bp, DACOUT),         // 28 PD6/AIN6
+    _PIN_DESC(PD, PIN7_bp, NOT_ON_TIMER),   // 29 PD7/AIN7/AREF
+    _PIN_DESC(PE, PIN0_bp, NOT_ON_TIMER),   // 30 PE0/AIN8
+    _PIN_DESC(PE, PIN1_bp, NOT_ON_TIMER),   // 31 PE1/AIN9
+    _PIN_DESC(PE, PIN2_bp, NOT_ON_TIMER),   // 32 PE2/AIN10
+    _PIN_DESC(PE, PIN3_bp, NOT_ON_TIMER),   // 33 PE3/AIN11
+    _PIN_DESC(PF, PIN0_bp, NOT_ON_TIMER),   // 34 PF0/AIN16/USART2_Tx/TOSC1
+    _PIN_DESC(PF, PIN1_bp, NOT_ON_TIMER),   // 35 PF1/AIN17/USART2_Rx/TOSC2
+    _PIN_DESC(PF, PIN2_bp, NOT_ON_TIMER),   // 36 PF2/AIN18
+    _PIN_DESC(PF, PIN3_bp, NOT_ON_TIMER),   // 37 PF3/AIN19
+    _PIN_DESC(PF, PIN4_bp, TIMERB0),        // 38 PF4/AIN20
+    _PIN_DESC(PF, PIN5_bp, TIMERB1),        // 39 PF5/AIN21
+    _PIN_DESC(PF, PIN6_bp, NOT_ON_TIMER)    // 40 PF6 RESET
+  };
 #endif
 
 #endif
@@ -0,0 +1,126 @@
+# Generates the digital_pin_to_descriptor[] table in each variant's pins_arduino.h, and in
+# extras/VariantTemplate.h, from the digital_pin_to_port, _bit_position, _bit_mask and _timer
+# tables in the same file.
+# Run from anywhere after editing any of those tables:
+#     python3 make_pin_descriptors.py
+# The only #if blocks the tables may contain are ones that choose between a value and NOT_A_PIN
+# for a single pin (like PA0 and PA1 when a crystal is used); they are carried over to the new table.
+import os
+import re
+
+VARIANTS = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "..", "variants")
+TEMPLATE = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "VariantTemplate.h")
+TABLES = ("digital_pin_to_port", "digital_pin_to_bit_position", "digital_pin_to_bit_mask", "digital_pin_to_timer")
+MARKER = "/* Generated by extras/development/make_pin_descriptors.py"
+INVALID = ("NOT_A_PIN", "NOT_A_PORT")
+
+
+def table_body(text, name):
+  m = re.search(r"const uint8_t " + name + r"\[\]\s*=\s*\{(.*?)\n\s*\};", text, re.S)
+  if not m:
+    raise ValueError("no table " + name)
+  return m.group(1)
+
+
+def parse(body):
+  """Returns a list of entries; each is (value, comment) or ('#if', condition, if_value, else_value, comment)."""
+  entries = []
+  cond = None
+  body = re.sub(r"/\*.*?\*/", "", body, flags=re.S)
+  for line in body.split("\n"):
+    code, _, comment = line.partition("//")
+    code = code.strip()
+    comment = comment.strip()
+    if code.startswith("#if"):
+      cond = [code.split("//")[0].strip(), [], [], comment, 1]
+      continue
+    if code.startswith("#else"):
+      cond[4] = 2
+      continue
+    if code.startswith("#endif"):
+      if len(cond[1]) != 1 or len(cond[2]) != 1:
+        raise ValueError("conditional block must hold one value per branch: " + cond[0])
+      entries.append(("#if", cond[0], cond[1][0], cond[2][0], cond[3]))
+      cond = None
+      continue
+    for value in [v.strip() for v in code.split(",") if v.strip()]:
+      if cond:
+        cond[cond[4]].append(value)
+        if comment:
+          cond[3] = comment
+      else:
+        entries.append((value, comment))
+  return entries
+
+
+def descriptor(port, bit_pos, bit_mask, timer):
+  if port in INVALID or bit_pos in INVALID or bit_mask in INVALID:
+    return "_PIN_DESC_NONE"
+  return "_PIN_DESC(%s, %s, %s)" % (port, bit_pos, timer)
+
+
+def generate(text):
+  tables = [parse(table_body(text, name)) for name in TABLES]
+  count = len(tables[0])
+  if any(len(t) != count for t in tables):
+    raise ValueError("tables have different lengths: " + str([len(t) for t in tables]))
+  rows = []
+  for i in range(count):
+    entries = [t[i] for t in tables]
+    comment = entries[0][-1] or next((e[-1] for e in entries if e[-1]), "")
+    comment = re.sub(r"^\d+\s*", "", comment)  # we number the rows ourselves
+    conds = set(e[1] for e in entries if e[0] == "#if")
+    if len(conds) > 1:
+      raise ValueError("pin %d has different conditions in different tables" % i)
+    if conds:
+      branch_a = [e[2] if e[0] == "#if" else e[0] for e in entries]
+      branch_b = [e[3] if e[0] == "#if" else e[0] for e in entries]
+      rows.append(("#if", conds.pop(), descriptor(*branch_a), descriptor(*branch_b), comment))
+    else:
+      rows.append((descriptor(*[e[0] for e in entries]), comment))
+  return rows
+
+
+def render(rows, indent):
+  inner = indent + "  "
+  width = max(len(row[2]) + 2 if row[0] == "#if" else len(row[0]) for row in rows) + 1
+  out = [indent + MARKER + " from the tables above - rerun it after changing them. */",
+         indent + "const pin_descriptor_t digital_pin_to_descriptor[] = {"]
+  for i, row in enumerate(rows):
+    sep = "," if i < len(rows) - 1 else " "
+    if row[0] == "#if":
+      out.append(inner + row[1])
+      out.append(inner + ("  " + row[2] + sep).ljust(width) + " // %2d %s" % (i, row[4]))
+      out.append(inner + "#else")
+      out.append(inner + "  " + row[3] + sep)
+      out.append(inner + "#endif")
+    else:
+      out.append(inner + (row[0] + sep).ljust(width) + " // %2d %s" % (i, row[1]))
+  out.append(indent + "};")
+  return "\n".join(line.rstrip() for line in out) + "\n"
+
+
+def update(path):
+  with open(path) as f:
+    text = f.read()
+  start = text.index("#ifdef ARDUINO_MAIN")
+  end = text.index("\n#endif", start) + 1
+  section = text[start:end]
+  old = section.find(MARKER)
+  if old >= 0:
+    section = section[:section.rindex("\n", 0, old) + 1]
+  indent = re.search(r"\n([ \t]*)const uint8_t digital_pin_to_port", section).group(1)
+  section = section.rstrip("\n") + "\n\n" + render(generate(section), indent)
+  text = text[:start] + section + text[end:]
+  with open(path, "w") as f:
+    f.write(text)
+
+
+if __name__ == "__main__":
+  for variant in sorted(os.listdir(VARIANTS)):
+    path = os.path.join(VARIANTS, variant, "pins_arduino.h")
+    if os.path.exists(path):
+      update(path)
+      print(variant)
+  update(TEMPLATE)
+  print("VariantTemplate.h")
@@ -0,0 +1,130 @@
+/*
+Digital I/O benchmark
+
+Measures how many system clock cycles digitalWrite(), digitalRead() and pinMode() take for every pin, when the pin
+number isn't known at compile time (it's read from a volatile variable, as it is when it comes from a library or a
+table). Run it on the same board with two versions of the core to compare them - the pin number is the Arduino pin
+number, and pins with PWM are marked with a *, since digitalWrite() has to turn PWM off on those.
+
+We use a type B timer counting at the system clock, so the numbers are in CPU clock cycles, and include the call
+overhead. The time it takes to just start and read the timer is measured first and subtracted. Interrupts are off
+while timing. The direction, output value and PINnCTRL of each pin are put back after it's tested; the serial pins
+are skipped. Note that the pin is briefly driven by the pinMode() test - don't run this on a board where that could
+damage something.
+
+We use TCB0 unless that is the millis timer, in which case we use TCB1.
+*/
+
+#if defined(MILLIS_USE_TIMERB0)
+  #define BENCH_TCB TCB1
+#else
+  #define BENCH_TCB TCB0
+#endif
+
+volatile uint8_t benchPin;
+volatile uint8_t benchVal;
+uint16_t overhead;
+
+uint16_t timeEmpty() {
+  uint8_t oldSREG = SREG;
+  cli();
+  BENCH_TCB.CNT = 0;
+  uint16_t elapsed = BENCH_TCB.CNT;
+  SREG = oldSREG;
+  return elapsed;
+}
+
+uint16_t timeDigitalWrite(uint8_t val) {
+  uint8_t oldSREG = SREG;
+  cli();
+  BENCH_TCB.CNT = 0;
+  digitalWrite(benchPin, val);
+  uint16_t elapsed = BENCH_TCB.CNT;
+  SREG = oldSREG;
+  return elapsed - overhead;
+}
+
+uint16_t timeDigitalRead() {
+  uint8_t oldSREG = SREG;
+  cli();
+  BENCH_TCB.CNT = 0;
+  benchVal = digitalRead(benchPin);
+  uint16_t elapsed = BENCH_TCB.CNT;
+  SREG = oldSREG;
+  return elapsed - overhead;
+}
+
+uint16_t timePinMode(uint8_t mode) {
+  uint8_t oldSREG = SREG;
+  cli();
+  BENCH_TCB.CNT = 0;
+  pinMode(benchPin, mode);
+  uint16_t elapsed = BENCH_TCB.CNT;
+  SREG = oldSREG;
+  return elapsed - overhead;
+}
+
+void setup() {
+  BENCH_TCB.CTRLB = TCB_CNTMODE_INT_gc; // periodic interrupt mode, but with the interrupt off - it just counts
+  BENCH_TCB.CCMP  = 0xFFFF;
+  BENCH_TCB.CTRLA = TCB_ENABLE_bm;      // CLKPER, no prescaling
+  Serial.begin(115200);
+  Serial.println();
+  overhead = timeEmpty();
+  Serial.println("Pin, digitalWrite LOW, digitalWrite HIGH, digitalRead, pinMode OUTPUT, pinMode INPUT (clock cycles)");
+}
+
+void loop() {
+  for (uint8_t pin = 0; pin < NUM_TOTAL_PINS; pin++) {
+    if (digitalPinToBitMask(pin) == NOT_A_PIN || pin == PIN_HWSERIAL0_TX || pin == PIN_HWSERIAL0_RX) {
+      continue;
+    }
+    PORT_t *port = digitalPinToPortStruct(pin);
+    uint8_t mask = digitalPinToBitMask(pin);
+    volatile uint8_t *pinctrl = getPINnCTRLregister(port, digitalPinToBitPosition(pin));
+    uint8_t oldSREG = SREG;
+    cli();
+    uint8_t dir = port->DIR & mask;
+    uint8_t out = port->OUT & mask;
+    uint8_t ctrl = *pinctrl;
+    SREG = oldSREG;
+
+    benchPin = pin;
+    uint16_t writeLow   = timeDigitalWrite(LOW);
+    uint16_t writeHigh  = timeDigitalWrite(HIGH);
+    uint16_t read       = timeDigitalRead();
+    uint16_t modeOutput = timePinMode(OUTPUT);
+    uint16_t modeInput  = timePinMode(INPUT);
+
+    cli();
+    *pinctrl = ctrl;
+    if (out) {
+      port->OUTSET = mask;
+    } else {
+      port->OUTCLR = mask;
+    }
+    if (dir) {
+      port->DIRSET = mask;
+    } else {
+      port->DIRCLR = mask;
+    }
+    SREG = oldSREG;
+
+    Serial.print(pin);
+    if (digitalPinHasPWM(pin)) {
+      Serial.print('*');
+    }
+    Serial.print(", ");
+    Serial.print(writeLow);
+    Serial.print(", ");
+    Serial.print(writeHigh);
+    Serial.print(", ");
+    Serial.print(read);
+    Serial.print(", ");
+    Serial.print(modeOutput);
+    Serial.print(", ");
+    Serial.println(modeInput);
+  }
+  Serial.flush();
+  while (1);
+}
@@ -0,0 +1,100 @@
+/*
+ISR timing
+
+Prints how many system clock cycles the core's own interrupts take - the millis timer, attachInterrupt(), Servo and
+the receive and transmit interrupts of each serial port - as fewest, average and most, along with how many times
+each one ran, and how much of the CPU they took between reports.
+
+This needs the core built with CORE_ISR_TIMING defined. That has to apply to the whole build, not just the sketch, so
+add it to the compiler flags, for example with a platform.local.txt next to platform.txt containing:
+  compiler.c.extra_flags=-DCORE_ISR_TIMING
+  compiler.cpp.extra_flags=-DCORE_ISR_TIMING
+A type B timer is taken over to count the clocks (see isr_timing.h for which one, and how to pick a different one).
+
+The counts are from the first instruction of the ISR (for the ones written in assembly) or the first line of the body
+(for the ones in C) to just before it returns, so the few clocks it takes to get into and out of any interrupt are not
+included, and the few that the instrumentation itself takes are. While it measures, this sketch prints a line now and
+then, so there is some serial traffic, and toggles PIN_PA2, so that connecting it to PIN_PA3 exercises an
+attachInterrupt() handler. Send it some characters to see the receive interrupt.
+*/
+
+#if !defined(CORE_ISR_TIMING)
+  #error "This sketch needs the core to be built with CORE_ISR_TIMING defined - see the comments at the top."
+#endif
+
+volatile uint16_t edges;
+
+void onEdge() {
+  edges++;
+}
+
+isr_timing_t records[ISR_TIMING_COUNT];
+
+void printRecord(uint8_t id, uint32_t interval) {
+  isr_timing_t &t = records[id];
+  if (t.count == 0) {
+    Serial.println(": did not run");
+    return;
+  }
+  Serial.print(": ran ");
+  Serial.print(t.count);
+  Serial.print(" times, min ");
+  Serial.print(t.min);
+  Serial.print(", avg ");
+  Serial.print(t.total / t.count);
+  Serial.print(", max ");
+  Serial.print(t.max);
+  Serial.print(" clocks, ");
+  Serial.print(100.0 * t.total / interval);
+  Serial.println("% of the CPU");
+}
+
+void setup() {
+  Serial.begin(115200);
+  pinMode(PIN_PA2, OUTPUT);
+  pinMode(PIN_PA3, INPUT_PULLUP);
+  attachInterrupt(digitalPinToInterrupt(PIN_PA3), onEdge, CHANGE);
+}
+
+void loop() {
+  isrTimingReset();
+  uint32_t start = millis();
+  uint8_t i = 0;
+  while (millis() - start < 1000) {
+    digitalWrite(PIN_PA2, !digitalRead(PIN_PA2));
+    if (++i == 100) {
+      Serial.print("Serial TX keeps the DRE interrupt busy for a while. ");
+      i = 0;
+    }
+    delay(1);
+  }
+  uint32_t interval = (millis() - start) * (F_CPU / 1000);
+  // Take all the readings before printing any, so the printing doesn't show up in them.
+  for (uint8_t id = 0; id < ISR_TIMING_COUNT; id++) {
+    isrTimingGet(id, &records[id]);
+  }
+  Serial.println();
+  Serial.print("millis");
+  printRecord(ISR_TIMING_MILLIS, interval);
+  Serial.print("attachInterrupt");
+  printRecord(ISR_TIMING_ATTACH, interval);
+  Serial.print("Servo");
+  printRecord(ISR_TIMING_SERVO, interval);
+  for (uint8_t n = 0; n < 6; n++) {
+    if (records[ISR_TIMING_USART_RXC(n)].count) {
+      Serial.print("USART");
+      Serial.print(n);
+      Serial.print(" RXC");
+      printRecord(ISR_TIMING_USART_RXC(n), interval);
+    }
+    if (records[ISR_TIMING_USART_DRE(n)].count) {
+      Serial.print("USART");
+      Serial.print(n);
+      Serial.print(" DRE");
+      printRecord(ISR_TIMING_USART_DRE(n), interval);
+    }
+  }
+  Serial.print("Edges seen: ");
+  Serial.println(edges);
+  Serial.flush();
+}
@@ -0,0 +1,74 @@
+/*
+Serial block write benchmark
+
+Compares the number of system clock cycles it takes to get a block of data into the serial TX buffer using
+HardwareSerial::write(buffer, size) - which copies the data into the ring buffer in one or two chunks - against the
+generic Print::write(buffer, size), which calls write(uint8_t) once for every byte.
+
+We use a type B timer counting at the system clock to measure it, so the numbers are in CPU clock cycles, and include
+the overhead of the call itself. Interrupts are disabled while timing so that the DRE interrupt doesn't fire in the middle
+and get counted; for that reason the block is smaller than the TX buffer, and we flush() between the tests.
+The first byte of the byte loop goes straight to TXDATA (the buffer is empty and DREIF is set), which slightly flatters
+the byte loop. It is still much slower.
+
+We use TCB0 unless that is the millis timer, in which case we use TCB1.
+*/
+
+#if defined(MILLIS_USE_TIMERB0)
+  #define BENCH_TCB TCB1
+#else
+  #define BENCH_TCB TCB0
+#endif
+
+#define BLOCK_SIZE (SERIAL_TX_BUFFER_SIZE - 2)
+
+uint8_t block[BLOCK_SIZE];
+
+uint16_t timeBlockWrite(uint8_t len) {
+  Serial.flush();
+  uint8_t oldSREG = SREG;
+  cli();
+  BENCH_TCB.CNT = 0;
+  Serial.write(block, len);
+  uint16_t elapsed = BENCH_TCB.CNT;
+  SREG = oldSREG;
+  return elapsed;
+}
+
+uint16_t timeByteLoop(uint8_t len) {
+  Serial.flush();
+  uint8_t oldSREG = SREG;
+  cli();
+  BENCH_TCB.CNT = 0;
+  Serial.Print::write(block, len); // explicitly call the generic implementation, which loops over write(uint8_t)
+  uint16_t elapsed = BENCH_TCB.CNT;
+  SREG = oldSREG;
+  return elapsed;
+}
+
+void setup() {
+  for (uint8_t i = 0; i < BLOCK_SIZE; i++) {
+    block[i] = 'A' + (i & 0x0F);
+  }
+  BENCH_TCB.CTRLB = TCB_CNTMODE_INT_gc; // periodic interrupt mode, but with the interrupt off - it just counts
+  BENCH_TCB.CCMP  = 0xFFFF;
+  BENCH_TCB.CTRLA = TCB_ENABLE_bm;      // CLKPER, no prescaling
+  Serial.begin(115200);
+  Serial.println();
+  Serial.println("Bytes, Print::write() byte loop, HardwareSerial::write() block (clock cycles)");
+}
+
+void loop() {
+  for (uint8_t len = 1; len <= BLOCK_SIZE; len <<= 1) {
+    uint16_t looped = timeByteLoop(len);
+    uint16_t bulk   = timeBlockWrite(len);
+    Serial.println();
+    Serial.print(len);
+    Serial.print(", ");
+    Serial.print(looped);
+    Serial.print(", ");
+    Serial.println(bulk);
+  }
+  Serial.flush();
+  while (1);
+}
@@ -0,0 +1,196 @@
+/*
+  SD Benchmark
+
+  Times the things that caching and streaming changes to the library
+  are meant to speed up, so they can be compared between versions and
+  between cards:
+  - sequential write and read of a file with write() and read()
+  - random 512 byte reads from that file
+  - listing a directory with openNextFile()
+  - opening and closing a file in that directory
+
+  If the library is built with SD_CARD_STATS defined as 1 (for the
+  whole build, for example in platform.local.txt - defining it in the
+  sketch is not enough), each result is followed by the number of
+  commands sent to the card, the blocks read and written, and the time
+  spent waiting for the card.
+
+  Everything this writes goes into the BENCH directory, which is
+  deleted first if it exists.
+
+  The circuit:
+  - SD card attached to SPI bus, CS on the default SS pin.
+
+  This example code is in the public domain.
+*/
+
+#include <SD.h>
+
+const uint16_t fileBlocks = 512;   // 256 KiB test file
+const uint16_t randomReads = 200;
+const uint8_t dirFiles = 32;
+const uint8_t openRepeats = 20;
+
+uint8_t buf[512];
+
+void startTest() {
+  #if SD_CARD_STATS
+  SD.clearCardStats();
+  #endif
+}
+
+void endTest(const char *name, uint32_t micro, uint32_t bytes) {
+  Serial.print(name);
+  Serial.print(": ");
+  Serial.print(micro / 1000);
+  Serial.print(" ms");
+  if (bytes) {
+    Serial.print(", ");
+    // bytes per ms is close enough to KB/s
+    Serial.print(bytes / (micro / 1000 + 1));
+    Serial.print(" KB/s");
+  }
+  Serial.println();
+  #if SD_CARD_STATS
+  const sd_card_stats_t &stats = SD.cardStats();
+  Serial.print("  commands ");
+  Serial.print(stats.commands);
+  Serial.print(", blocks read ");
+  Serial.print(stats.blocksRead);
+  Serial.print(", blocks written ");
+  Serial.print(stats.blocksWritten);
+  Serial.print(", busy ");
+  Serial.print(stats.busyMicros / 1000);
+  Serial.print(" ms, read wait ");
+  Serial.print(stats.readWaitMicros / 1000);
+  Serial.println(" ms");
+  #endif
+}
+
+void fail(const char *msg) {
+  Serial.println(msg);
+  while (1);
+}
+
+void removeBenchDir() {
+  File dir = SD.open("BENCH");
+  if (!dir) {
+    return;
+  }
+  while (true) {
+    File entry = dir.openNextFile();
+    if (!entry) {
+      break;
+    }
+    char path[20] = "BENCH/";
+    strcat(path, entry.name());
+    entry.close();
+    SD.remove(path);
+  }
+  dir.close();
+  SD.rmdir("BENCH");
+}
+
+void setup() {
+  Serial.begin(115200);
+  if (!SD.begin()) {
+    fail("Card failed, or not present");
+  }
+  removeBenchDir();
+  if (!SD.mkdir("BENCH")) {
+    fail("Could not create BENCH");
+  }
+  for (uint16_t i = 0; i < sizeof(buf); i++) {
+    buf[i] = i;
+  }
+
+  // sequential write
+  startTest();
+  uint32_t start = micros();
+  File file = SD.open("BENCH/DATA.BIN", FILE_WRITE);
+  if (!file) {
+    fail("Could not create BENCH/DATA.BIN");
+  }
+  for (uint16_t i = 0; i < fileBlocks; i++) {
+    if (file.write(buf, sizeof(buf)) != sizeof(buf)) {
+      fail("Write failed");
+    }
+  }
+  file.close();
+  endTest("Sequential write", micros() - start, (uint32_t)fileBlocks * 512);
+
+  // sequential read
+  startTest();
+  start = micros();
+  file = SD.open("BENCH/DATA.BIN");
+  for (uint16_t i = 0; i < fileBlocks; i++) {
+    if (file.read(buf, sizeof(buf)) != sizeof(buf)) {
+      fail("Read failed");
+    }
+  }
+  file.close();
+  endTest("Sequential read", micros() - start, (uint32_t)fileBlocks * 512);
+
+  // random reads
+  randomSeed(1);
+  startTest();
+  start = micros();
+  file = SD.open("BENCH/DATA.BIN");
+  for (uint16_t i = 0; i < randomReads; i++) {
+    file.seek((uint32_t)random(fileBlocks) * 512);
+    if (file.read(buf, sizeof(buf)) != sizeof(buf)) {
+      fail("Read failed");
+    }
+  }
+  file.close();
+  endTest("Random 512 byte reads", micros() - start, (uint32_t)randomReads * 512);
+
+  // fill the directory, then list it
+  char name[] = "BENCH/FILE00.TXT";
+  for (uint8_t i = 0; i < dirFiles; i++) {
+    name[10] = '0' + i / 10;
+    name[11] = '0' + i % 10;
+    file = SD.open(name, FILE_WRITE);
+    file.print(i);
+    file.close();
+  }
+  startTest();
+  start = micros();
+  File dir = SD.open("BENCH");
+  uint8_t count = 0;
+  while (true) {
+    File entry = dir.openNextFile();
+    if (!entry) {
+      break;
+    }
+    entry.close();
+    count++;
+  }
+  dir.close();
+  endTest("Directory listing", micros() - start, 0);
+  Serial.print("  ");
+  Serial.print(count);
+  Serial.println(" entries");
+
+  // open the last file in the directory repeatedly
+  startTest();
+  start = micros();
+  for (uint8_t i = 0; i < openRepeats; i++) {
+    file = SD.open(name);
+    if (!file) {
+      fail("Open failed");
+    }
+    file.close();
+  }
+  uint32_t elapsed = micros() - start;
+  endTest("File open and close", elapsed, 0);
+  Serial.print("  ");
+  Serial.print(elapsed / openRepeats);
+  Serial.println(" us each");
+
+  removeBenchDir();
+  Serial.println("Done");
+}
+
+void loop() {
+}
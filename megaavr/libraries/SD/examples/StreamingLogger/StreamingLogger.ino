@@ -0,0 +1,94 @@
+/*
+  Streaming Logger
+
+  This example shows how to write and read large amounts of data
+  quickly by streaming whole 512 byte blocks to and from a file with
+  the SD card's multiple block commands, instead of going through
+  write() and read(), which copy everything through a single block
+  cache and wait for the card after every block.
+
+  The file needs to be contiguous for this, so we allocate space for it
+  up front with preAllocate(). Between writeStreamStart() and
+  writeStreamStop() (or readStreamStart() and readStreamStop()) nothing
+  else may access the card.
+
+  The circuit:
+  - SD card attached to SPI bus, CS on the default SS pin.
+
+  This example code is in the public domain.
+*/
+
+#include <SD.h>
+
+const char filename[] = "stream.bin";
+const uint16_t blockCount = 1024; // 512 KiB
+
+uint8_t block[512];
+
+void setup() {
+  Serial.begin(115200);
+
+  if (!SD.begin()) {
+    Serial.println("Card failed, or not present");
+    while (1);
+  }
+  SD.remove(filename);
+
+  File dataFile = SD.open(filename, FILE_WRITE);
+  if (!dataFile || !dataFile.preAllocate((uint32_t)blockCount * 512)) {
+    Serial.println("Could not create a contiguous file");
+    while (1);
+  }
+
+  // write
+  uint32_t start = millis();
+  if (!dataFile.writeStreamStart()) {
+    Serial.println("writeStreamStart failed");
+    while (1);
+  }
+  for (uint16_t i = 0; i < blockCount; i++) {
+    // your data goes here - we just fill each block with its number.
+    memset(block, (uint8_t)i, sizeof(block));
+    if (!dataFile.writeStreamBlock(block)) {
+      Serial.println("writeStreamBlock failed");
+      break;
+    }
+  }
+  dataFile.writeStreamStop();
+  uint32_t elapsed = millis() - start;
+  dataFile.close();
+  Serial.print("Wrote ");
+  Serial.print(blockCount / 2);
+  Serial.print(" KiB in ");
+  Serial.print(elapsed);
+  Serial.println(" ms");
+
+  // read it back
+  dataFile = SD.open(filename, FILE_READ);
+  uint16_t errors = 0;
+  start = millis();
+  if (!dataFile.readStreamStart()) {
+    Serial.println("readStreamStart failed");
+    while (1);
+  }
+  for (uint16_t i = 0; i < blockCount; i++) {
+    if (dataFile.readStreamBlock(block) != 512) {
+      Serial.println("readStreamBlock failed");
+      break;
+    }
+    if (block[0] != (uint8_t)i || block[511] != (uint8_t)i) {
+      errors++;
+    }
+  }
+  dataFile.readStreamStop();
+  elapsed = millis() - start;
+  dataFile.close();
+  Serial.print("Read back in ");
+  Serial.print(elapsed);
+  Serial.print(" ms, ");
+  Serial.print(errors);
+  Serial.println(" bad blocks");
+}
+
+void loop() {
+}
@@ -0,0 +1,315 @@
+/* Sd2Card for the host build: the same class as ../../src/utility/Sd2Card.h, but the blocks come from the image that
+ * sdImage points to instead of a card on the SPI bus.
+ *
+ * It sends the same commands the real one does, in the same order, and counts them and the blocks transferred the
+ * same way when SD_CARD_STATS is set. Instead of the bytes, the time they would take at timing.spiKHz is added to
+ * sdSimNanos, and so is the card's busy time, which is counted in busyMicros and readWaitMicros where the real code
+ * would be waiting for it. A write that isn't blocking leaves the card busy until the simulated clock catches up,
+ * like a real card, so the time only gets counted if something has to wait for it.
+ */
+#include <Arduino.h>
+#include "Sd2Card.h"
+#include "SdImage.h"
+
+static uint64_t busyUntil = 0;    // sdSimNanos when the card stops being busy
+static uint32_t streamBlock = 0;  // next block of a CMD18 read or CMD25 write
+static uint8_t blockBuf[512];     // the block being read, for partial block reads
+
+// time for some bytes on the bus
+static void spiBytes(uint32_t count) {
+  sdSimNanos += (uint64_t)count * 8000000UL / sdImage->timing.spiKHz;
+}
+
+static void cardBusy(uint16_t micros) {
+  busyUntil = sdSimNanos + (uint64_t)micros * 1000;
+}
+//------------------------------------------------------------------------------
+// send command and return error code.  Return zero for OK
+uint8_t Sd2Card::cardCommand(uint8_t cmd, uint32_t arg) {
+  (void)arg;
+  readEnd();
+  #if SD_CARD_STATS
+  stats_.commands++;
+  #endif
+  chipSelectLow();
+  if (cmd != CMD12) {
+    waitNotBusy(300);
+  }
+  // the command, CRC and the response; CMD12 also has a stuff byte
+  spiBytes(cmd == CMD12 ? 8 : 7);
+  status_ = 0;
+  return status_;
+}
+//------------------------------------------------------------------------------
+/** \return The number of 512 byte blocks in the image */
+uint32_t Sd2Card::cardSize(void) {
+  return sdImage ? sdImage->blockCount() : 0;
+}
+//------------------------------------------------------------------------------
+void Sd2Card::chipSelectHigh(void) {
+}
+//------------------------------------------------------------------------------
+void Sd2Card::chipSelectLow(void) {
+}
+//------------------------------------------------------------------------------
+/** Erase a range of blocks - the image is filled with zeros. */
+uint8_t Sd2Card::erase(uint32_t firstBlock, uint32_t lastBlock) {
+  memset(blockBuf, 0, sizeof(blockBuf));
+  cardCommand(CMD32, firstBlock);
+  cardCommand(CMD33, lastBlock);
+  cardCommand(CMD38, 0);
+  for (uint32_t b = firstBlock; b <= lastBlock; b++) {
+    if (!sdImage->writeBlock(b, blockBuf)) {
+      error(SD_CARD_ERROR_ERASE);
+      chipSelectHigh();
+      return false;
+    }
+  }
+  cardBusy(sdImage->timing.eraseBusyMicros);
+  waitNotBusy(SD_ERASE_TIMEOUT);
+  chipSelectHigh();
+  return true;
+}
+//------------------------------------------------------------------------------
+uint8_t Sd2Card::eraseSingleBlockEnable(void) {
+  return true;
+}
+//------------------------------------------------------------------------------
+/** Attach to the image that sdImage points to. It looks like an SDHC card. */
+uint8_t Sd2Card::init(uint8_t sckRateID, uint8_t chipSelectPin) {
+  errorCode_ = inBlock_ = partialBlockRead_ = type_ = 0;
+  chipSelectPin_ = chipSelectPin;
+  if (!sdImage || !sdImage->blockCount()) {
+    error(SD_CARD_ERROR_CMD0);
+    return false;
+  }
+  busyUntil = sdSimNanos;
+  type(SD_CARD_TYPE_SDHC);
+  return setSckRate(sckRateID);
+}
+//------------------------------------------------------------------------------
+uint8_t Sd2Card::isBusy(void) {
+  chipSelectLow();
+  spiBytes(1);
+  chipSelectHigh();
+  return sdSimNanos < busyUntil;
+}
+//------------------------------------------------------------------------------
+void Sd2Card::partialBlockRead(uint8_t value) {
+  readEnd();
+  partialBlockRead_ = value;
+}
+//------------------------------------------------------------------------------
+uint8_t Sd2Card::readBlock(uint32_t block, uint8_t *dst) {
+  return readData(block, 0, 512, dst);
+}
+//------------------------------------------------------------------------------
+uint8_t Sd2Card::readData(uint32_t block, uint16_t offset, uint16_t count, uint8_t *dst) {
+  if (count == 0) {
+    return true;
+  }
+  if ((count + offset) > 512) {
+    chipSelectHigh();
+    return false;
+  }
+  if (!inBlock_ || block != block_ || offset < offset_) {
+    block_ = block;
+    cardCommand(CMD17, block);
+    if (!sdImage->readBlock(block, blockBuf)) {
+      error(SD_CARD_ERROR_CMD17);
+      chipSelectHigh();
+      return false;
+    }
+    if (!waitStartBlock()) {
+      return false;
+    }
+    offset_ = 0;
+    inBlock_ = 1;
+    #if SD_CARD_STATS
+    stats_.blocksRead++;
+    #endif
+  }
+  spiBytes(offset - offset_ + count);
+  memcpy(dst, blockBuf + offset, count);
+  offset_ = offset + count;
+  if (!partialBlockRead_ || offset_ >= 512) {
+    readEnd();
+  }
+  return true;
+}
+//------------------------------------------------------------------------------
+uint8_t Sd2Card::readData(uint8_t *dst) {
+  if (!waitStartBlock()) {
+    return false;
+  }
+  if (!sdImage->readBlock(streamBlock++, dst)) {
+    error(SD_CARD_ERROR_READ);
+    return false;
+  }
+  #if SD_CARD_STATS
+  stats_.blocksRead++;
+  #endif
+  spiBytes(512 + 2);
+  return true;
+}
+//------------------------------------------------------------------------------
+void Sd2Card::readEnd(void) {
+  if (inBlock_) {
+    // the rest of the data and the crc
+    spiBytes(514 - offset_);
+    chipSelectHigh();
+    inBlock_ = 0;
+  }
+}
+//------------------------------------------------------------------------------
+uint8_t Sd2Card::readStart(uint32_t blockNumber) {
+  cardCommand(CMD18, blockNumber);
+  streamBlock = blockNumber;
+  return true;
+}
+//------------------------------------------------------------------------------
+uint8_t Sd2Card::readStop(void) {
+  cardCommand(CMD12, 0);
+  if (!waitNotBusy(SD_READ_TIMEOUT)) {
+    error(SD_CARD_ERROR_CMD12);
+    chipSelectHigh();
+    return false;
+  }
+  chipSelectHigh();
+  return true;
+}
+//------------------------------------------------------------------------------
+uint8_t Sd2Card::setSckRate(uint8_t sckRateID) {
+  if (sckRateID > 6) {
+    error(SD_CARD_ERROR_SCK_RATE);
+    return false;
+  }
+  return true;
+}
+//------------------------------------------------------------------------------
+uint8_t Sd2Card::setSpiClock(uint32_t clock) {
+  sdImage->timing.spiKHz = clock / 1000;
+  return true;
+}
+//------------------------------------------------------------------------------
+// wait for card to go not busy
+uint8_t Sd2Card::waitNotBusy(unsigned int timeoutMillis) {
+  uint8_t ready = true;
+  #if SD_CARD_STATS
+  uint64_t ns = sdSimNanos;
+  #endif
+  if (busyUntil > sdSimNanos) {
+    if (busyUntil - sdSimNanos > (uint64_t)timeoutMillis * 1000000) {
+      sdSimNanos += (uint64_t)timeoutMillis * 1000000;
+      ready = false;
+    } else {
+      sdSimNanos = busyUntil;
+    }
+  }
+  // the byte that comes back 0XFF
+  spiBytes(1);
+  #if SD_CARD_STATS
+  stats_.busyMicros += (sdSimNanos - ns) / 1000;
+  #endif
+  return ready;
+}
+//------------------------------------------------------------------------------
+/** Wait for start block token */
+uint8_t Sd2Card::waitStartBlock(void) {
+  sdSimNanos += (uint64_t)sdImage->timing.readAccessMicros * 1000;
+  spiBytes(1);
+  #if SD_CARD_STATS
+  stats_.readWaitMicros += sdImage->timing.readAccessMicros;
+  #endif
+  return true;
+}
+//------------------------------------------------------------------------------
+uint8_t Sd2Card::writeBlock(uint32_t blockNumber, const uint8_t *src, uint8_t blocking) {
+  #if SD_PROTECT_BLOCK_ZERO
+  if (blockNumber == 0) {
+    error(SD_CARD_ERROR_WRITE_BLOCK_ZERO);
+    chipSelectHigh();
+    return false;
+  }
+  #endif  // SD_PROTECT_BLOCK_ZERO
+  cardCommand(CMD24, blockNumber);
+  streamBlock = blockNumber;
+  if (!writeData(DATA_START_BLOCK, src)) {
+    return false;
+  }
+  cardBusy(sdImage->timing.writeBusyMicros);
+  if (blocking) {
+    if (!waitNotBusy(SD_WRITE_TIMEOUT)) {
+      error(SD_CARD_ERROR_WRITE_TIMEOUT);
+      chipSelectHigh();
+      return false;
+    }
+    // CMD13, and the second byte of its R2 response
+    cardCommand(CMD13, 0);
+    spiBytes(1);
+  }
+  chipSelectHigh();
+  return true;
+}
+//------------------------------------------------------------------------------
+uint8_t Sd2Card::writeData(const uint8_t *src) {
+  if (!waitNotBusy(SD_WRITE_TIMEOUT)) {
+    error(SD_CARD_ERROR_WRITE_MULTIPLE);
+    chipSelectHigh();
+    return false;
+  }
+  if (!writeData(WRITE_MULTIPLE_TOKEN, src)) {
+    return false;
+  }
+  cardBusy(sdImage->timing.streamBusyMicros);
+  return true;
+}
+//------------------------------------------------------------------------------
+// send one block of data for write block or write multiple blocks
+uint8_t Sd2Card::writeData(uint8_t token, const uint8_t *src) {
+  (void)token;
+  // token, data, crc and the data response
+  spiBytes(1 + 512 + 2 + 1);
+  if (!sdImage->writeBlock(streamBlock++, src)) {
+    error(SD_CARD_ERROR_WRITE);
+    chipSelectHigh();
+    return false;
+  }
+  #if SD_CARD_STATS
+  stats_.blocksWritten++;
+  #endif
+  return true;
+}
+//------------------------------------------------------------------------------
+uint8_t Sd2Card::writeStart(uint32_t blockNumber, uint32_t eraseCount) {
+  #if SD_PROTECT_BLOCK_ZERO
+  if (blockNumber == 0) {
+    error(SD_CARD_ERROR_WRITE_BLOCK_ZERO);
+    chipSelectHigh();
+    return false;
+  }
+  #endif  // SD_PROTECT_BLOCK_ZERO
+  cardAcmd(ACMD23, eraseCount);
+  cardCommand(CMD25, blockNumber);
+  streamBlock = blockNumber;
+  return true;
+}
+//------------------------------------------------------------------------------
+uint8_t Sd2Card::writeStop(void) {
+  if (!waitNotBusy(SD_WRITE_TIMEOUT)) {
+    goto fail;
+  }
+  // stop token
+  spiBytes(1);
+  cardBusy(sdImage->timing.stopBusyMicros);
+  if (!waitNotBusy(SD_WRITE_TIMEOUT)) {
+    goto fail;
+  }
+  chipSelectHigh();
+  return true;
+
+fail:
+  error(SD_CARD_ERROR_STOP_TRAN);
+  chipSelectHigh();
+  return false;
+}
@@ -0,0 +1,229 @@
+/* Disk image and simulated clock for the host build - see SdImage.h */
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
+// SdFat.h replaces the O_ flags with its own, so get the ones open() wants first
+static const int openCreate = O_RDWR | O_CREAT | O_TRUNC;
+static const int openExisting = O_RDWR;
+#include <Arduino.h>
+#include "SdImage.h"
+#include "SdFat.h"
+
+SdImage *sdImage = NULL;
+uint64_t sdSimNanos = 0;
+
+HostSerial Serial;
+
+size_t HostSerial::write(uint8_t b) {
+  return putchar(b) == EOF ? 0 : 1;
+}
+
+unsigned long millis(void) {
+  return sdSimNanos / 1000000;
+}
+
+unsigned long micros(void) {
+  return sdSimNanos / 1000;
+}
+//------------------------------------------------------------------------------
+SdImage::SdImage(void) : fd_(-1), blocks_(0) {
+  timing.spiKHz           = 8000;
+  timing.readAccessMicros = 250;
+  timing.writeBusyMicros  = 1200;
+  timing.streamBusyMicros = 250;
+  timing.stopBusyMicros   = 600;
+  timing.eraseBusyMicros  = 2000;
+}
+
+SdImage::~SdImage(void) {
+  close();
+}
+//------------------------------------------------------------------------------
+/** Create an image of the given size, all zeros. It is a sparse file, so a big one doesn't use much disk. */
+uint8_t SdImage::create(const char *path, uint32_t blocks) {
+  close();
+  fd_ = ::open(path, openCreate, 0644);
+  if (fd_ < 0) {
+    return false;
+  }
+  if (ftruncate(fd_, (off_t)blocks * 512)) {
+    close();
+    return false;
+  }
+  blocks_ = blocks;
+  return true;
+}
+//------------------------------------------------------------------------------
+/** Use an existing image, for example one written with dd from a real card */
+uint8_t SdImage::open(const char *path) {
+  close();
+  fd_ = ::open(path, openExisting);
+  if (fd_ < 0) {
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd_, &st) || st.st_size < 512) {
+    close();
+    return false;
+  }
+  blocks_ = st.st_size / 512;
+  return true;
+}
+//------------------------------------------------------------------------------
+void SdImage::close(void) {
+  if (fd_ >= 0) {
+    ::close(fd_);
+  }
+  fd_ = -1;
+  blocks_ = 0;
+}
+//------------------------------------------------------------------------------
+uint8_t SdImage::readBlock(uint32_t block, uint8_t *dst) {
+  if (block >= blocks_) {
+    return false;
+  }
+  return pread(fd_, dst, 512, (off_t)block * 512) == 512;
+}
+//------------------------------------------------------------------------------
+uint8_t SdImage::writeBlock(uint32_t block, const uint8_t *src) {
+  if (block >= blocks_) {
+    return false;
+  }
+  return pwrite(fd_, src, 512, (off_t)block * 512) == 512;
+}
+//------------------------------------------------------------------------------
+/**
+   Format the image with an MBR and one FAT16 or FAT32 partition, laid out the
+   way the SD association's formatter does it: the partition starts at block
+   2048, with two FATs.
+
+   \return false if the image is the wrong size for that FAT type with that
+   cluster size - FAT16 needs 4085 to 65524 clusters, FAT32 at least 65525.
+*/
+uint8_t SdImage::format(uint8_t fatType, uint8_t blocksPerCluster) {
+  const uint32_t volumeStart = 2048;
+  if ((fatType != 16 && fatType != 32) || blocks_ <= volumeStart) {
+    return false;
+  }
+  uint32_t volumeBlocks = blocks_ - volumeStart;
+  uint16_t reserved = fatType == 32 ? 32 : 1;
+  uint16_t rootEntries = fatType == 32 ? 0 : 512;
+  uint32_t rootBlocks = rootEntries / 16;
+  uint16_t entriesPerBlock = fatType == 32 ? 128 : 256;
+  // a bigger FAT leaves fewer clusters, so go around until it's big enough
+  uint32_t fatBlocks = 1;
+  uint32_t clusters;
+  for (;;) {
+    uint32_t overhead = reserved + 2 * fatBlocks + rootBlocks;
+    if (overhead >= volumeBlocks) {
+      return false;
+    }
+    clusters = (volumeBlocks - overhead) / blocksPerCluster;
+    uint32_t need = (clusters + 2 + entriesPerBlock - 1) / entriesPerBlock;
+    if (need <= fatBlocks) {
+      break;
+    }
+    fatBlocks = need;
+  }
+  if (fatType == 16 ? (clusters < 4085 || clusters >= 65525) : clusters < 65525) {
+    return false;
+  }
+  uint32_t dataStart = volumeStart + reserved + 2 * fatBlocks + rootBlocks;
+
+  // clear out everything up to the data area, and the FAT32 root directory cluster
+  cache_t b;
+  memset(&b, 0, sizeof(b));
+  for (uint32_t i = 0; i < dataStart + (fatType == 32 ? blocksPerCluster : 0); i++) {
+    if (!writeBlock(i, b.data)) {
+      return false;
+    }
+  }
+
+  // MBR
+  part_t *p = &b.mbr.part[0];
+  p->type = fatType == 32 ? 0X0C : 0X06;
+  p->firstSector = volumeStart;
+  p->totalSectors = volumeBlocks;
+  b.mbr.mbrSig0 = BOOTSIG0;
+  b.mbr.mbrSig1 = BOOTSIG1;
+  if (!writeBlock(0, b.data)) {
+    return false;
+  }
+
+  // boot sector
+  memset(&b, 0, sizeof(b));
+  fbs_t *fbs = &b.fbs;
+  bpb_t *bpb = &fbs->bpb;
+  fbs->jmpToBootCode[0] = 0XEB;
+  fbs->jmpToBootCode[1] = 0X00;
+  fbs->jmpToBootCode[2] = 0X90;
+  memcpy(fbs->oemName, "DXCORE  ", 8);
+  bpb->bytesPerSector = 512;
+  bpb->sectorsPerCluster = blocksPerCluster;
+  bpb->reservedSectorCount = reserved;
+  bpb->fatCount = 2;
+  bpb->rootDirEntryCount = rootEntries;
+  bpb->mediaType = 0XF8;
+  bpb->sectorsPerTrtack = 63;
+  bpb->headCount = 255;
+  bpb->hidddenSectors = volumeStart;
+  if (fatType == 16 && volumeBlocks < 0X10000) {
+    bpb->totalSectors16 = volumeBlocks;
+  } else {
+    bpb->totalSectors32 = volumeBlocks;
+  }
+  if (fatType == 16) {
+    bpb->sectorsPerFat16 = fatBlocks;
+    // FAT16 has the drive number, serial and label right after the common part of the BPB
+    b.data[36] = 0X80;
+    b.data[38] = 0X29;
+    memcpy(&b.data[43], "NO NAME    FAT16   ", 19);
+  } else {
+    bpb->sectorsPerFat32 = fatBlocks;
+    bpb->fat32RootCluster = 2;
+    bpb->fat32FSInfo = 1;
+    bpb->fat32BackBootBlock = 6;
+    fbs->driveNumber = 0X80;
+    fbs->bootSignature = 0X29;
+    memcpy(fbs->volumeLabel, "NO NAME    ", 11);
+    memcpy(fbs->fileSystemType, "FAT32   ", 8);
+  }
+  fbs->bootSectorSig0 = BOOTSIG0;
+  fbs->bootSectorSig1 = BOOTSIG1;
+  if (!writeBlock(volumeStart, b.data)) {
+    return false;
+  }
+  if (fatType == 32) {
+    if (!writeBlock(volumeStart + 6, b.data)) {
+      return false;
+    }
+    // FSINFO - everything is free except the root directory, which is cluster 2
+    memset(&b, 0, sizeof(b));
+    b.fat32[0] = FSINFO_LEAD_SIG;
+    b.fat32[121] = FSINFO_STRUCT_SIG;
+    b.fat32[122] = clusters - 1;
+    b.fat32[123] = 3;
+    b.fat32[127] = 0XAA550000;
+    if (!writeBlock(volumeStart + 1, b.data) || !writeBlock(volumeStart + 7, b.data)) {
+      return false;
+    }
+  }
+
+  // the first FAT block of both FATs: the two reserved entries, and the FAT32 root directory
+  memset(&b, 0, sizeof(b));
+  if (fatType == 16) {
+    b.fat16[0] = 0XFFF8;
+    b.fat16[1] = FAT16EOC;
+  } else {
+    b.fat32[0] = 0X0FFFFFF8;
+    b.fat32[1] = FAT32EOC;
+    b.fat32[2] = FAT32EOC;
+  }
+  for (uint8_t i = 0; i < 2; i++) {
+    if (!writeBlock(volumeStart + reserved + i * fatBlocks, b.data)) {
+      return false;
+    }
+  }
+  return true;
+}
@@ -0,0 +1,50 @@
+/* An SD card for the host build: a disk image file, plus a model of how long the card takes to do things.
+ *
+ * The stub Sd2Card in Sd2CardImage.cpp reads and writes blocks of the image that sdImage points to. Instead of the
+ * real time, it adds up what each transfer would take on the SPI bus, and how long the card would be busy, in a
+ * simulated clock, sdSimNanos, which is also what millis() and micros() return. Along with the SD_CARD_STATS
+ * counters, that gives numbers that only depend on what the library asked the card to do, so they can be compared
+ * from one version of the library to the next.
+ */
+#ifndef SdImage_h
+#define SdImage_h
+
+#include <stdint.h>
+
+/* How long things take on the simulated card. The defaults are in the range of an ordinary class 10 card, on an
+ * 8 MHz SPI clock; they're a model, not a measurement, so only compare numbers made with the same ones. */
+typedef struct {
+  uint32_t spiKHz;            // SPI clock - each byte on the bus takes 8 of these
+  uint16_t readAccessMicros;  // from a read command (or the previous block of a CMD18 read) to the data token
+  uint16_t writeBusyMicros;   // busy after a single block write (CMD24)
+  uint16_t streamBusyMicros;  // busy after each block of a multiple block write (CMD25)
+  uint16_t stopBusyMicros;    // busy after the stop token that ends a multiple block write
+  uint16_t eraseBusyMicros;   // busy after an erase, per call
+} sd_image_timing_t;
+
+class SdImage {
+  public:
+    SdImage(void);
+    ~SdImage(void);
+    uint8_t create(const char *path, uint32_t blocks);
+    uint8_t open(const char *path);
+    void close(void);
+    uint8_t format(uint8_t fatType, uint8_t blocksPerCluster);
+    uint8_t readBlock(uint32_t block, uint8_t *dst);
+    uint8_t writeBlock(uint32_t block, const uint8_t *src);
+    /** \return The size of the image in 512 byte blocks */
+    uint32_t blockCount(void) const {
+      return blocks_;
+    }
+    sd_image_timing_t timing;
+  private:
+    int fd_;
+    uint32_t blocks_;
+};
+
+/** The image the stub Sd2Card uses - must be set before Sd2Card::init() */
+extern SdImage *sdImage;
+/** Simulated time in ns, advanced by the stub Sd2Card */
+extern uint64_t sdSimNanos;
+
+#endif  // SdImage_h
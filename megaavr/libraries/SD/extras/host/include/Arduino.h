@@ -0,0 +1,45 @@
+/* Just enough of Arduino.h to build the SD library's FAT code on a PC, for the host build in extras/host.
+ * millis() and micros() return the simulated time kept by the image-backed Sd2Card, not the real time. */
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Print.h"
+
+typedef bool    boolean;
+typedef uint8_t byte;
+
+#define LOW    0
+#define HIGH   1
+#define INPUT  0
+#define OUTPUT 1
+
+// Sd2PinMap.h wants these; the stub card doesn't use any pins.
+#define SS     10
+#define MOSI   11
+#define MISO   12
+#define SCK    13
+
+unsigned long millis(void);
+unsigned long micros(void);
+
+inline void pinMode(uint8_t pin, uint8_t mode) {
+  (void)pin;
+  (void)mode;
+}
+inline void digitalWrite(uint8_t pin, uint8_t val) {
+  (void)pin;
+  (void)val;
+}
+
+class HostSerial : public Print {
+  public:
+    size_t write(uint8_t b);
+    using Print::write;
+};
+extern HostSerial Serial;
+
+#endif
@@ -0,0 +1,84 @@
+/* The parts of the core's Print class that the SD library uses, for the host build in extras/host. */
+#ifndef Print_h
+#define Print_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#define DEC 10
+#define HEX 16
+
+class Print {
+  private:
+    int write_error = 0;
+  protected:
+    void setWriteError(int err = 1) {
+      write_error = err;
+    }
+  public:
+    virtual ~Print() {}
+    int getWriteError() {
+      return write_error;
+    }
+    void clearWriteError() {
+      setWriteError(0);
+    }
+    virtual size_t write(uint8_t) = 0;
+    virtual size_t write(const uint8_t *buffer, size_t size) {
+      size_t n = 0;
+      while (size--) {
+        n += write(*buffer++);
+      }
+      return n;
+    }
+    size_t write(const char *str) {
+      return str ? write(reinterpret_cast<const uint8_t *>(str), strlen(str)) : 0;
+    }
+    virtual int availableForWrite() {
+      return 0;
+    }
+
+    size_t print(const char *str) {
+      return write(str);
+    }
+    size_t print(char c) {
+      return write(static_cast<uint8_t>(c));
+    }
+    size_t print(unsigned long n, int base = DEC) {
+      char buf[8 * sizeof(long) + 1];
+      char *str = &buf[sizeof(buf) - 1];
+      *str = '\0';
+      do {
+        unsigned long m = n;
+        n /= base;
+        char c = m - base * n;
+        *--str = c < 10 ? c + '0' : c + 'A' - 10;
+      } while (n);
+      return write(str);
+    }
+    size_t print(long n, int base = DEC) {
+      if (n < 0 && base == DEC) {
+        return print('-') + print(static_cast<unsigned long>(-n), base);
+      }
+      return print(static_cast<unsigned long>(n), base);
+    }
+    size_t print(unsigned int n, int base = DEC) {
+      return print(static_cast<unsigned long>(n), base);
+    }
+    size_t print(int n, int base = DEC) {
+      return print(static_cast<long>(n), base);
+    }
+    size_t print(unsigned char n, int base = DEC) {
+      return print(static_cast<unsigned long>(n), base);
+    }
+    size_t println(void) {
+      return write("\r\n");
+    }
+    template <typename T> size_t println(T value) {
+      size_t n = print(value);
+      return n + println();
+    }
+};
+
+#endif
@@ -0,0 +1,288 @@
+/* Benchmarks for the SD library's FAT code, run on the host against the image-backed Sd2Card.
+ *
+ *   sdbench [image]
+ *
+ * Formats a FAT16 and a FAT32 image, or, with an argument, uses an image that's already formatted (like one copied
+ * off a card with dd - it gets files written to it), and times sequential writes and reads, streaming, random reads,
+ * a directory scan, opening files by name and counting free clusters.
+ * Times are the simulated card time (see SdImage.h), so they're the same from run to run, and only change when the
+ * library changes what it asks the card to do. The host CPU time is printed too, but don't read much into it.
+ */
+#include <stdio.h>
+#include <time.h>
+#include <Arduino.h>
+#include "SdFat.h"
+#include "SdImage.h"
+
+static Sd2Card card;
+static SdVolume volume;
+static SdFile root;
+
+static uint64_t startNanos;
+static clock_t startClock;
+
+static uint8_t buf[512];
+
+static uint32_t seed = 1;
+static uint32_t random32(void) {
+  seed = seed * 1664525UL + 1013904223UL;
+  return seed;
+}
+
+static void begin(void) {
+  card.clearStats();
+  startNanos = sdSimNanos;
+  startClock = clock();
+}
+
+// bytes is 0 for tests that aren't about throughput, count is the number of operations, for the per-op time
+static void end(const char *name, uint32_t bytes, uint32_t count) {
+  double ms = (sdSimNanos - startNanos) / 1e6;
+  double cpu = (clock() - startClock) * 1000.0 / CLOCKS_PER_SEC;
+  const sd_card_stats_t &s = card.stats();
+  printf("%-26s %10.2f ms", name, ms);
+  if (bytes) {
+    printf(" %8.1f KB/s", bytes / 1.024 / ms);
+  } else if (count) {
+    printf(" %8.3f ms/op", ms / count);
+  } else {
+    printf("              ");
+  }
+  printf(" %7lu cmd %7lu rd %7lu wr %9.2f ms busy %9.2f ms wait %8.2f ms cpu\n",
+         (unsigned long)s.commands, (unsigned long)s.blocksRead, (unsigned long)s.blocksWritten,
+         s.busyMicros / 1000.0, s.readWaitMicros / 1000.0, cpu);
+}
+
+static void fail(const char *what) {
+  printf("FAILED: %s (card error 0X%02X)\n", what, card.errorCode());
+  exit(1);
+}
+
+static void fill(uint32_t pos) {
+  for (uint16_t i = 0; i < 512; i++) {
+    buf[i] = (pos + i) * 7;
+  }
+}
+//------------------------------------------------------------------------------
+static void sequentialWrite(const char *name, uint32_t size, uint16_t chunk, uint16_t syncEvery) {
+  SdFile f;
+  char label[40];
+  snprintf(label, sizeof(label), "write %u B%s", chunk, syncEvery ? " + sync" : "");
+  begin();
+  if (!f.open(&root, name, O_CREAT | O_WRITE | O_TRUNC)) {
+    fail("open for write");
+  }
+  uint32_t n = 0;
+  for (uint32_t pos = 0; pos < size; pos += chunk) {
+    fill(pos);
+    if (f.write(buf, chunk) != chunk) {
+      fail("write");
+    }
+    if (syncEvery && ++n % syncEvery == 0 && !f.sync()) {
+      fail("sync");
+    }
+  }
+  if (!f.close()) {
+    fail("close");
+  }
+  end(label, size, 0);
+}
+//------------------------------------------------------------------------------
+static void sequentialRead(const char *name, uint16_t chunk) {
+  SdFile f;
+  char label[40];
+  snprintf(label, sizeof(label), "read %u B", chunk);
+  if (!f.open(&root, name, O_READ)) {
+    fail("open for read");
+  }
+  begin();
+  uint32_t total = 0;
+  int16_t n;
+  while ((n = f.read(buf, chunk)) > 0) {
+    total += n;
+  }
+  if (n < 0) {
+    fail("read");
+  }
+  end(label, total, 0);
+  f.close();
+}
+//------------------------------------------------------------------------------
+static void streamWrite(const char *name, uint32_t size) {
+  SdFile f;
+  begin();
+  if (!f.createContiguous(&root, name, size)) {
+    fail("createContiguous");
+  }
+  end("create contiguous", 0, 0);
+  // createContiguous() leaves the file at its full size; write it again from the start
+  f.rewind();
+  begin();
+  if (!f.writeStreamStart()) {
+    fail("writeStreamStart");
+  }
+  for (uint32_t pos = 0; pos < size; pos += 512) {
+    fill(pos);
+    if (!f.writeStreamBlock(buf)) {
+      fail("writeStreamBlock");
+    }
+  }
+  if (!f.writeStreamStop()) {
+    fail("writeStreamStop");
+  }
+  end("stream write", size, 0);
+  f.close();
+}
+//------------------------------------------------------------------------------
+static void streamRead(const char *name) {
+  SdFile f;
+  if (!f.open(&root, name, O_READ)) {
+    fail("open for stream read");
+  }
+  begin();
+  if (!f.readStreamStart()) {
+    fail("readStreamStart");
+  }
+  uint32_t total = 0;
+  int16_t n;
+  while ((n = f.readStreamBlock(buf)) > 0) {
+    total += n;
+  }
+  if (n < 0 || !f.readStreamStop()) {
+    fail("readStreamBlock");
+  }
+  end("stream read", total, 0);
+  f.close();
+}
+//------------------------------------------------------------------------------
+static void randomRead(const char *name, uint16_t chunk, uint16_t count) {
+  SdFile f;
+  char label[40];
+  snprintf(label, sizeof(label), "random read %u B", chunk);
+  if (!f.open(&root, name, O_READ)) {
+    fail("open for random read");
+  }
+  uint32_t size = f.fileSize() - chunk;
+  begin();
+  for (uint16_t i = 0; i < count; i++) {
+    if (!f.seekSet(random32() % size) || f.read(buf, chunk) != chunk) {
+      fail("random read");
+    }
+  }
+  end(label, 0, count);
+  f.close();
+}
+//------------------------------------------------------------------------------
+static void directory(uint16_t files) {
+  SdFile dir;
+  SdFile f;
+  char name[13];
+  if (!dir.makeDir(&root, "BENCHDIR")) {
+    fail("makeDir");
+  }
+  begin();
+  for (uint16_t i = 0; i < files; i++) {
+    snprintf(name, sizeof(name), "F%04u.TXT", i);
+    if (!f.open(&dir, name, O_CREAT | O_WRITE | O_EXCL) || f.write(name) != strlen(name) || !f.close()) {
+      fail("create in directory");
+    }
+  }
+  end("create files", 0, files);
+
+  dir_t entry;
+  uint16_t found = 0;
+  begin();
+  dir.rewind();
+  while (dir.readDir(&entry) > 0) {
+    found++;
+  }
+  end("directory scan", 0, 0);
+  if (found != files) {
+    fail("directory scan found the wrong number of files");
+  }
+
+  // every file in the directory, by name - the later ones have to search further
+  begin();
+  for (uint16_t i = 0; i < files; i++) {
+    snprintf(name, sizeof(name), "F%04u.TXT", i);
+    if (!f.open(&dir, name, O_READ)) {
+      fail("open by name");
+    }
+    f.close();
+  }
+  end("open by name", 0, files);
+
+  // the one that isn't there is the worst case: the whole directory is searched
+  begin();
+  if (f.open(&dir, "MISSING.TXT", O_READ)) {
+    fail("opened a file that isn't there");
+  }
+  end("open missing file", 0, 1);
+  dir.close();
+}
+//------------------------------------------------------------------------------
+static void freeClusters(void) {
+  begin();
+  int32_t n = volume.freeClusterCount();
+  if (n < 0) {
+    fail("freeClusterCount");
+  }
+  end("free clusters (first)", 0, 0);
+  begin();
+  volume.freeClusterCount();
+  end("free clusters (again)", 0, 0);
+  printf("%ld of %lu clusters free\n", (long)n, (unsigned long)volume.clusterCount());
+}
+//------------------------------------------------------------------------------
+static void mount(void) {
+  if (!card.init(SPI_FULL_SPEED)) {
+    fail("card.init");
+  }
+  if (!volume.init(&card)) {
+    fail("volume.init");
+  }
+  if (!root.openRoot(&volume)) {
+    fail("openRoot");
+  }
+  printf("FAT%u, %u blocks per cluster, %lu clusters, %u cache blocks\n", volume.fatType(),
+         volume.blocksPerCluster(), (unsigned long)volume.clusterCount(), SD_CACHE_BLOCKS);
+}
+
+static void run(void) {
+  seed = 1;
+  mount();
+  sequentialWrite("SEQ.BIN", 1024UL * 1024, 512, 0);
+  sequentialRead("SEQ.BIN", 512);
+  sequentialWrite("LOG.TXT", 100UL * 1000, 100, 10);
+  sequentialRead("LOG.TXT", 100);
+  streamWrite("STREAM.BIN", 1024UL * 1024);
+  streamRead("STREAM.BIN");
+  randomRead("SEQ.BIN", 64, 1000);
+  directory(200);
+  freeClusters();
+  root.close();
+  printf("\n");
+}
+
+int main(int argc, char **argv) {
+  SdImage image;
+  sdImage = &image;
+  if (argc > 1) {
+    if (!image.open(argv[1])) {
+      printf("can't open %s\n", argv[1]);
+      return 1;
+    }
+    run();
+    return 0;
+  }
+  // 64 MB with 2 KB clusters, and 1 GB with 4 KB clusters - sparse files, so they don't use that much disk
+  if (!image.create("sdbench16.img", 64UL * 2048) || !image.format(16, 4)) {
+    fail("FAT16 image");
+  }
+  run();
+  if (!image.create("sdbench32.img", 1024UL * 2048) || !image.format(32, 8)) {
+    fail("FAT32 image");
+  }
+  run();
+  return 0;
+}
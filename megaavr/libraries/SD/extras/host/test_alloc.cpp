@@ -0,0 +1,223 @@
+/* Checks SdVolume's cluster allocation, which skips parts of the FAT that the free space summary says are full,
+ * against the plain linear search it replaced, and freeClusterCount() against a count of the free entries.
+ *
+ * The FAT of a freshly formatted image is filled in with a pattern that has a long, nearly full stretch (that the
+ * summary should let the search skip), a fragmented one, and free space at the end. Then thousands of random
+ * allocations and frees are done through SdVolume, and each one is compared with what the old algorithm would have
+ * picked from a copy of the FAT kept here. The whole FAT is compared with the copy at the end, and again after
+ * remounting, which throws the summary away.
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <Arduino.h>
+// the allocator and the FAT access functions are private
+#define private public
+#include "SdFat.h"
+#undef private
+#include "SdImage.h"
+
+static Sd2Card card;
+static SdVolume vol;
+static std::vector<uint32_t> fat;  // what the FAT should hold
+static uint32_t failures = 0;
+
+static uint32_t seed = 1;
+static uint32_t random32(void) {
+  seed = seed * 1664525UL + 1013904223UL;
+  return seed >> 8;
+}
+
+#define CHECK(cond, ...) do {                          \
+    if (!(cond)) {                                     \
+      printf("FAIL line %d: ", __LINE__);              \
+      printf(__VA_ARGS__);                             \
+      printf("\n");                                    \
+      if (++failures > 10) {                           \
+        exit(1);                                       \
+      }                                                \
+    }                                                  \
+  } while (0)
+
+static uint32_t eoc(void) {
+  return vol.fatType() == 16 ? FAT16EOC : FAT32EOC;
+}
+//------------------------------------------------------------------------------
+/* allocContiguous() as it was before the free space summary, minus the writes: where would it put count clusters?
+ * \return the first cluster of the run, or 0 if there's no room */
+static uint32_t linearSearch(uint32_t count, uint32_t curCluster, uint32_t searchStart) {
+  uint32_t bgnCluster = curCluster ? curCluster + 1 : searchStart;
+  uint32_t endCluster = bgnCluster;
+  uint32_t fatEnd = vol.clusterCount() + 1;
+  for (uint32_t n = 0;; n++, endCluster++) {
+    if (n >= vol.clusterCount()) {
+      return 0;
+    }
+    if (endCluster > fatEnd) {
+      bgnCluster = endCluster = 2;
+    }
+    if (fat[endCluster] != 0) {
+      bgnCluster = endCluster + 1;
+    } else if ((endCluster - bgnCluster + 1) == count) {
+      return bgnCluster;
+    }
+  }
+}
+
+static uint32_t freeInModel(void) {
+  uint32_t n = 0;
+  for (uint32_t c = 2; c <= vol.clusterCount() + 1; c++) {
+    n += fat[c] == 0;
+  }
+  return n;
+}
+
+static void compareFat(const char *when) {
+  uint32_t bad = 0;
+  for (uint32_t c = 2; c <= vol.clusterCount() + 1; c++) {
+    uint32_t v;
+    if (!vol.fatGet(c, &v)) {
+      CHECK(0, "fatGet(%lu) failed %s", (unsigned long)c, when);
+      return;
+    }
+    if (v != fat[c] && bad++ < 5) {
+      CHECK(0, "cluster %lu is 0X%lX, expected 0X%lX %s", (unsigned long)c, (unsigned long)v,
+            (unsigned long)fat[c], when);
+    }
+  }
+}
+
+static void mount(void) {
+  CHECK(card.init(SPI_FULL_SPEED), "card.init");
+  CHECK(vol.init(&card), "vol.init");
+}
+//------------------------------------------------------------------------------
+/* Mark clusters in use straight in the FAT. Each one is a chain of its own, so freeing the ones the test allocates
+ * never runs into them. */
+static void fragment(void) {
+  uint32_t last = vol.clusterCount() + 1;
+  fat.assign(last + 1, 0);
+  fat[0] = fat[1] = eoc();
+  if (vol.fatType() == 32) {
+    fat[2] = eoc();  // root directory
+  }
+  for (uint32_t c = 2; c <= last; c++) {
+    uint32_t pos = (uint64_t)(c - 2) * 1000 / (last - 1);
+    uint8_t used;
+    if (pos < 600) {
+      // nearly full - most groups have no free cluster at all. Free ones are mostly at the first or last cluster
+      // of a 256 cluster block, which is where a summary group starts or ends, so skipping one is checked closely.
+      if ((c & 0XFF) == 0 || (c & 0XFF) == 0XFF) {
+        used = random32() % 4 != 0;
+      } else {
+        used = random32() % 8192 != 0;
+      }
+    } else if (pos < 900) {
+      used = random32() % 3 != 0;     // fragmented, short free runs
+    } else {
+      used = false;                   // free at the end
+    }
+    if (used && fat[c] == 0) {
+      fat[c] = eoc();
+      CHECK(vol.fatPut(c, eoc()), "fatPut while fragmenting");
+    }
+  }
+  CHECK(SdVolume::cacheFlush(), "cacheFlush");
+}
+//------------------------------------------------------------------------------
+static void allocate(std::vector<uint32_t> &chains, uint32_t ops) {
+  static const uint32_t sizes[] = {1, 1, 1, 1, 2, 3, 4, 8, 16, 64, 200, 1000};
+  for (uint32_t i = 0; i < ops; i++) {
+    if (chains.size() && random32() % 10 < 3) {
+      // free one of ours
+      uint32_t k = random32() % chains.size();
+      uint32_t c = chains[k];
+      chains[k] = chains.back();
+      chains.pop_back();
+      CHECK(vol.freeChain(c), "freeChain(%lu)", (unsigned long)c);
+      for (;;) {
+        uint32_t next = fat[c];
+        fat[c] = 0;
+        if (next >= (vol.fatType() == 16 ? FAT16EOC_MIN : FAT32EOC_MIN)) {
+          break;
+        }
+        c = next;
+      }
+      continue;
+    }
+    uint32_t count = sizes[random32() % (sizeof(sizes) / sizeof(sizes[0]))];
+    // sometimes extend one of the fragmentation clusters, like a file growing - the search starts right after it
+    uint32_t cur = 0;
+    if (random32() % 4 == 0) {
+      uint32_t c = 2 + random32() % vol.clusterCount();
+      if (fat[c] == eoc()) {
+        cur = c;
+      }
+    }
+    uint32_t expected = linearSearch(count, cur, vol.allocSearchStart_);
+    uint32_t got = cur;
+    uint8_t ok = vol.allocContiguous(count, &got);
+    CHECK(ok == (expected != 0), "allocContiguous(%lu, %lu) returned %u, expected %u", (unsigned long)count,
+          (unsigned long)cur, ok, expected != 0);
+    if (!ok) {
+      continue;
+    }
+    CHECK(got == expected, "allocContiguous(%lu, %lu) gave cluster %lu, the linear search %lu",
+          (unsigned long)count, (unsigned long)cur, (unsigned long)got, (unsigned long)expected);
+    // follow what the library did, so one mismatch doesn't cause lots more
+    for (uint32_t c = got; c < got + count - 1; c++) {
+      fat[c] = c + 1;
+    }
+    fat[got + count - 1] = eoc();
+    if (cur) {
+      fat[cur] = got;
+    } else {
+      chains.push_back(got);
+    }
+  }
+}
+//------------------------------------------------------------------------------
+static void run(uint8_t fatType, uint32_t blocks, uint8_t blocksPerCluster) {
+  SdImage image;
+  sdImage = &image;
+  seed = fatType;
+  uint32_t before = failures;
+  CHECK(image.create("test_alloc.img", blocks) && image.format(fatType, blocksPerCluster), "format FAT%u", fatType);
+  mount();
+  fragment();
+
+  // the first count reads the whole FAT and fills in the summary
+  CHECK(vol.freeClusterCount() == (int32_t)freeInModel(), "freeClusterCount() is %ld, expected %lu",
+        (long)vol.freeClusterCount(), (unsigned long)freeInModel());
+
+  std::vector<uint32_t> chains;
+  for (uint8_t round = 0; round < 10; round++) {
+    allocate(chains, 500);
+    // kept up to date by fatPut() since the first count
+    CHECK(vol.freeClusterCount() == (int32_t)freeInModel(), "freeClusterCount() is %ld, expected %lu",
+          (long)vol.freeClusterCount(), (unsigned long)freeInModel());
+  }
+  CHECK(SdVolume::cacheFlush(), "cacheFlush");
+  compareFat("after allocating");
+
+  // without the summary, and without a count, until the allocator fills in the summary itself
+  mount();
+  allocate(chains, 2000);
+  CHECK(vol.freeClusterCount() == (int32_t)freeInModel(), "freeClusterCount() after remount is %ld, expected %lu",
+        (long)vol.freeClusterCount(), (unsigned long)freeInModel());
+  CHECK(SdVolume::cacheFlush(), "cacheFlush");
+  compareFat("after remount");
+
+  printf("FAT%u, %lu clusters, %lu free: %s\n", fatType, (unsigned long)vol.clusterCount(),
+         (unsigned long)freeInModel(), failures == before ? "ok" : "FAILED");
+  image.close();
+  remove("test_alloc.img");
+}
+
+int main(void) {
+  run(16, 64UL * 2048, 4);   // 64 MB, 2 KB clusters
+  run(32, 256UL * 2048, 1);  // 256 MB, 512 byte clusters, so the summary groups are bigger than one FAT block
+  return failures ? 1 : 0;
+}
@@ -145,6 +145,55 @@ uint32_t File::size() {
   return _file->fileSize();
 }
 
+boolean File::preAllocate(uint32_t size) {
+  if (! _file) {
+    return false;
+  }
+  return _file->preAllocate(size);
+}
+
+boolean File::writeStreamStart() {
+  if (! _file) {
+    return false;
+  }
+  return _file->writeStreamStart();
+}
+
+boolean File::writeStreamBlock(const uint8_t *block) {
+  if (! _file) {
+    return false;
+  }
+  return _file->writeStreamBlock(block);
+}
+
+boolean File::writeStreamStop() {
+  if (! _file) {
+    return false;
+  }
+  return _file->writeStreamStop();
+}
+
+boolean File::readStreamStart() {
+  if (! _file) {
+    return false;
+  }
+  return _file->readStreamStart();
+}
+
+int File::readStreamBlock(uint8_t *block) {
+  if (! _file) {
+    return -1;
+  }
+  return _file->readStreamBlock(block);
+}
+
+boolean File::readStreamStop() {
+  if (! _file) {
+    return false;
+  }
+  return _file->readStreamStop();
+}
+
 void File::close() {
   if (_file) {
     _file->close();
@@ -48,6 +48,16 @@ namespace SDLib {
       operator bool();
       char *name();
 
+      // Streaming access to contiguous files with multiple block commands,
+      // 512 bytes at a time, bypassing the cache. See SdFile for details.
+      boolean preAllocate(uint32_t size);
+      boolean writeStreamStart();
+      boolean writeStreamBlock(const uint8_t *block);
+      boolean writeStreamStop();
+      boolean readStreamStart();
+      int readStreamBlock(uint8_t *block);
+      boolean readStreamStop();
+
       boolean isDirectory(void);
       File openNextFile(uint8_t mode = O_RDONLY);
       void rewindDirectory(void);
@@ -106,6 +116,26 @@ namespace SDLib {
         return rmdir(filepath.c_str());
       }
 
+      // Number of free clusters on the card, or -1 on error. The first call reads
+      // the whole FAT, later ones return a count that is kept up to date.
+      int32_t freeClusterCount() {
+        return volume.freeClusterCount();
+      }
+      // Size of a cluster in bytes.
+      uint32_t clusterSize() {
+        return 512UL * volume.blocksPerCluster();
+      }
+
+      #if SD_CARD_STATS
+      // Counters for benchmarking, see Sd2Card.h. Only with SD_CARD_STATS defined for the whole build.
+      const sd_card_stats_t &cardStats() {
+        return card.stats();
+      }
+      void clearCardStats() {
+        card.clearStats();
+      }
+      #endif
+
     private:
 
       // This is used to determine the mode used to open a file
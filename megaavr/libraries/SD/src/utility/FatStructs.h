@@ -287,6 +287,11 @@ uint32_t const FAT32MASK = 0X0FFFFFFF;
 
 /** Type name for fat32BootSector */
 typedef struct fat32BootSector fbs_t;
+/** Signature at the start of the FAT32 FSINFO block */
+uint32_t const FSINFO_LEAD_SIG = 0X41615252;
+/** Signature at offset 484 of the FAT32 FSINFO block, followed by the
+    free cluster count and the next free cluster hint */
+uint32_t const FSINFO_STRUCT_SIG = 0X61417272;
 //------------------------------------------------------------------------------
 /**
    \struct directoryEntry
@@ -51,6 +51,26 @@ static  uint8_t spiRec(void) {
   return SDCARD_SPI.transfer(0xFF);
   #endif
 }
+/** Receive a run of bytes from the card */
+static void spiRec(uint8_t *dst, uint16_t count) {
+  #ifndef USE_SPI_LIB
+  for (uint16_t i = 0; i < count; i++) {
+    dst[i] = spiRec();
+  }
+  #else
+  SDCARD_SPI.receive(dst, count);
+  #endif
+}
+/** Send a run of bytes to the card */
+static void spiSend(const uint8_t *src, uint16_t count) {
+  #ifndef USE_SPI_LIB
+  for (uint16_t i = 0; i < count; i++) {
+    spiSend(src[i]);
+  }
+  #else
+  SDCARD_SPI.transmit(src, count);
+  #endif
+}
 #else  // SOFTWARE_SPI
 //------------------------------------------------------------------------------
 /** nop to tune soft SPI timing */
@@ -107,6 +127,20 @@ void spiSend(uint8_t data) {
   // enable interrupts
   sei();
 }
+//------------------------------------------------------------------------------
+/** Soft SPI receive a run of bytes */
+void spiRec(uint8_t *dst, uint16_t count) {
+  for (uint16_t i = 0; i < count; i++) {
+    dst[i] = spiRec();
+  }
+}
+//------------------------------------------------------------------------------
+/** Soft SPI send a run of bytes */
+void spiSend(const uint8_t *src, uint16_t count) {
+  for (uint16_t i = 0; i < count; i++) {
+    spiSend(src[i]);
+  }
+}
 #endif  // SOFTWARE_SPI
 //------------------------------------------------------------------------------
 // send command and return error code.  Return zero for OK
@@ -114,11 +148,18 @@ uint8_t Sd2Card::cardCommand(uint8_t cmd, uint32_t arg) {
   // end read if in partialBlockRead mode
   readEnd();
 
+  #if SD_CARD_STATS
+  stats_.commands++;
+  #endif
+
   // select card
   chipSelectLow();
 
-  // wait up to 300 ms if busy
-  waitNotBusy(300);
+  // wait up to 300 ms if busy - except for CMD12, which is sent while the
+  // card is in the middle of sending data for CMD18, so it is never "not busy".
+  if (cmd != CMD12) {
+    waitNotBusy(300);
+  }
 
   // send command
   spiSend(cmd | 0x40);
@@ -138,6 +179,11 @@ uint8_t Sd2Card::cardCommand(uint8_t cmd, uint32_t arg) {
   }
   spiSend(crc);
 
+  // CMD12 is followed by a stuff byte, which may look like a valid response
+  if (cmd == CMD12) {
+    spiRec();
+  }
+
   // wait for response
   for (uint8_t i = 0; ((status_ = spiRec()) & 0X80) && i != 0XFF; i++)
     ;
@@ -422,6 +468,9 @@ uint8_t Sd2Card::readData(uint32_t block,
     }
     offset_ = 0;
     inBlock_ = 1;
+    #if SD_CARD_STATS
+    stats_.blocksRead++;
+    #endif
   }
 
   #ifdef OPTIMIZE_HARDWARE_SPI
@@ -454,9 +503,7 @@ uint8_t Sd2Card::readData(uint32_t block,
     spiRec();
   }
   // transfer data
-  for (uint16_t i = 0; i < count; i++) {
-    dst[i] = spiRec();
-  }
+  spiRec(dst, count);
   #endif  // OPTIMIZE_HARDWARE_SPI
 
   offset_ += count;
@@ -471,6 +518,27 @@ fail:
   return false;
 }
 //------------------------------------------------------------------------------
+/** Read one data block in a multiple block read sequence
+
+   \param[out] dst Pointer to the location for the 512 bytes of data.
+
+   \return The value one, true, is returned for success and
+   the value zero, false, is returned for failure.
+*/
+uint8_t Sd2Card::readData(uint8_t *dst) {
+  if (!waitStartBlock()) {
+    return false;
+  }
+  #if SD_CARD_STATS
+  stats_.blocksRead++;
+  #endif
+  spiRec(dst, 512);
+  // discard crc
+  spiRec();
+  spiRec();
+  return true;
+}
+//------------------------------------------------------------------------------
 /** Skip remaining data in a block when in partial block read mode. */
 void Sd2Card::readEnd(void) {
   if (inBlock_) {
@@ -496,6 +564,51 @@ void Sd2Card::readEnd(void) {
   }
 }
 //------------------------------------------------------------------------------
+/** Start a read multiple blocks sequence.
+
+   \param[in] blockNumber Address of first block in sequence.
+
+   \note This function is used with readData() and readStop()
+   for optimized multiple block reads.  SPI chip select is low on return.
+
+   \return The value one, true, is returned for success and
+   the value zero, false, is returned for failure.
+*/
+uint8_t Sd2Card::readStart(uint32_t blockNumber) {
+  // use address if not SDHC card
+  if (type() != SD_CARD_TYPE_SDHC) {
+    blockNumber <<= 9;
+  }
+  if (cardCommand(CMD18, blockNumber)) {
+    error(SD_CARD_ERROR_CMD18);
+    goto fail;
+  }
+  return true;
+
+fail:
+  chipSelectHigh();
+  return false;
+}
+//------------------------------------------------------------------------------
+/** End a read multiple blocks sequence.
+
+  \return The value one, true, is returned for success and
+   the value zero, false, is returned for failure.
+*/
+uint8_t Sd2Card::readStop(void) {
+  // the R1b response to CMD12 is followed by busy while the card stops
+  if (cardCommand(CMD12, 0) || !waitNotBusy(SD_READ_TIMEOUT)) {
+    error(SD_CARD_ERROR_CMD12);
+    goto fail;
+  }
+  chipSelectHigh();
+  return true;
+
+fail:
+  chipSelectHigh();
+  return false;
+}
+//------------------------------------------------------------------------------
 /** read CID or CSR register */
 uint8_t Sd2Card::readRegister(uint8_t cmd, void *buf) {
   uint8_t *dst = reinterpret_cast<uint8_t *>(buf);
@@ -573,18 +686,29 @@ uint8_t Sd2Card::setSpiClock(uint32_t clock) {
 uint8_t Sd2Card::waitNotBusy(unsigned int timeoutMillis) {
   unsigned int t0 = millis();
   unsigned int d;
+  uint8_t ready = false;
+  #if SD_CARD_STATS
+  unsigned long us = micros();
+  #endif
   do {
     if (spiRec() == 0XFF) {
-      return true;
+      ready = true;
+      break;
     }
     d = millis() - t0;
   } while (d < timeoutMillis);
-  return false;
+  #if SD_CARD_STATS
+  stats_.busyMicros += micros() - us;
+  #endif
+  return ready;
 }
 //------------------------------------------------------------------------------
 /** Wait for start block token */
 uint8_t Sd2Card::waitStartBlock(void) {
   unsigned int t0 = millis();
+  #if SD_CARD_STATS
+  unsigned long us = micros();
+  #endif
   while ((status_ = spiRec()) == 0XFF) {
     unsigned int d = millis() - t0;
     if (d > SD_READ_TIMEOUT) {
@@ -592,6 +716,9 @@ uint8_t Sd2Card::waitStartBlock(void) {
       goto fail;
     }
   }
+  #if SD_CARD_STATS
+  stats_.readWaitMicros += micros() - us;
+  #endif
   if (status_ != DATA_START_BLOCK) {
     error(SD_CARD_ERROR_READ);
     goto fail;
@@ -686,9 +813,7 @@ uint8_t Sd2Card::writeData(uint8_t token, const uint8_t *src) {
 
   #else  // OPTIMIZE_HARDWARE_SPI
   spiSend(token);
-  for (uint16_t i = 0; i < 512; i++) {
-    spiSend(src[i]);
-  }
+  spiSend(src, 512);
   #endif  // OPTIMIZE_HARDWARE_SPI
   spiSend(0xff);  // dummy crc
   spiSend(0xff);  // dummy crc
@@ -699,6 +824,9 @@ uint8_t Sd2Card::writeData(uint8_t token, const uint8_t *src) {
     chipSelectHigh();
     return false;
   }
+  #if SD_CARD_STATS
+  stats_.blocksWritten++;
+  #endif
   return true;
 }
 //------------------------------------------------------------------------------
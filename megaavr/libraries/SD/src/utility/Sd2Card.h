@@ -160,6 +160,33 @@ uint8_t const SD_CARD_ERROR_WRITE_PROGRAMMING = 0X14;
 uint8_t const SD_CARD_ERROR_WRITE_TIMEOUT = 0X15;
 /** incorrect rate selected */
 uint8_t const SD_CARD_ERROR_SCK_RATE = 0X16;
+/** card returned an error response for CMD12 (stop multiple block read) */
+uint8_t const SD_CARD_ERROR_CMD12 = 0X17;
+/** card returned an error response for CMD18 (read multiple blocks) */
+uint8_t const SD_CARD_ERROR_CMD18 = 0X18;
+//------------------------------------------------------------------------------
+/**
+   If nonzero, Sd2Card counts commands, blocks transferred and the time spent
+   waiting for the card, for benchmarking.  Must be defined for the whole build.
+*/
+#ifndef SD_CARD_STATS
+  #define SD_CARD_STATS 0
+#endif
+#if SD_CARD_STATS
+/** Counters kept by Sd2Card when SD_CARD_STATS is nonzero */
+typedef struct {
+  /** Commands sent, including the CMD55 before each ACMD */
+  uint32_t commands;
+  /** Data blocks read (a partial block read counts as one) */
+  uint32_t blocksRead;
+  /** Data blocks written */
+  uint32_t blocksWritten;
+  /** Time spent waiting for the card to be ready (not busy) in us */
+  uint32_t busyMicros;
+  /** Time spent waiting for the start of read data in us */
+  uint32_t readWaitMicros;
+} sd_card_stats_t;
+#endif
 //------------------------------------------------------------------------------
 // card types
 /** Standard capacity V1 SD card */
@@ -176,7 +203,11 @@ uint8_t const SD_CARD_TYPE_SDHC = 3;
 class Sd2Card {
   public:
     /** Construct an instance of Sd2Card. */
-    Sd2Card(void) : errorCode_(0), inBlock_(0), partialBlockRead_(0), type_(0) {}
+    Sd2Card(void) : errorCode_(0), inBlock_(0), partialBlockRead_(0), type_(0) {
+      #if SD_CARD_STATS
+      clearStats();
+      #endif
+    }
     uint32_t cardSize(void);
     uint8_t erase(uint32_t firstBlock, uint32_t lastBlock);
     uint8_t eraseSingleBlockEnable(void);
@@ -227,7 +258,10 @@ class Sd2Card {
     uint8_t readCSD(csd_t *csd) {
       return readRegister(CMD9, csd);
     }
+    uint8_t readData(uint8_t *dst);
     void readEnd(void);
+    uint8_t readStart(uint32_t blockNumber);
+    uint8_t readStop(void);
     uint8_t setSckRate(uint8_t sckRateID);
     #ifdef USE_SPI_LIB
     uint8_t setSpiClock(uint32_t clock);
@@ -241,6 +275,16 @@ class Sd2Card {
     uint8_t writeStart(uint32_t blockNumber, uint32_t eraseCount);
     uint8_t writeStop(void);
     uint8_t isBusy(void);
+    #if SD_CARD_STATS
+    /** \return The counters accumulated since the last clearStats() */
+    const sd_card_stats_t &stats(void) const {
+      return stats_;
+    }
+    /** Reset all the counters to zero */
+    void clearStats(void) {
+      memset(&stats_, 0, sizeof(stats_));
+    }
+    #endif
   private:
     uint32_t block_;
     uint8_t chipSelectPin_;
@@ -250,6 +294,9 @@ class Sd2Card {
     uint8_t partialBlockRead_;
     uint8_t status_;
     uint8_t type_;
+    #if SD_CARD_STATS
+    sd_card_stats_t stats_;
+    #endif
     // private functions
     uint8_t cardAcmd(uint8_t cmd, uint32_t arg) {
       cardCommand(CMD55, 0);
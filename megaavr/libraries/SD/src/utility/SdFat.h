@@ -35,6 +35,47 @@
 */
 #define ALLOW_DEPRECATED_FUNCTIONS 1
 //------------------------------------------------------------------------------
+/**
+   Number of 512 byte blocks in the volume cache.  With more than one, the
+   first SD_CACHE_FAT_BLOCKS are used only for FAT blocks and the rest for
+   directory and file data, so appending to a file doesn't evict the FAT
+   block it needs every time it moves to a new data block.  Dirty blocks are
+   written back when they are evicted (least recently used first) or on
+   sync().  These must be defined for the whole build, not just the sketch.
+*/
+#ifndef SD_CACHE_BLOCKS
+  #if defined(RAMSIZE) && RAMSIZE >= 16384
+    #define SD_CACHE_BLOCKS 4
+  #elif defined(RAMSIZE) && RAMSIZE >= 8192
+    #define SD_CACHE_BLOCKS 2
+  #else
+    #define SD_CACHE_BLOCKS 1
+  #endif
+#endif
+#ifndef SD_CACHE_FAT_BLOCKS
+  /** Number of cache blocks reserved for the FAT, if SD_CACHE_BLOCKS > 1 */
+  #define SD_CACHE_FAT_BLOCKS (SD_CACHE_BLOCKS / 2)
+#endif
+#if SD_CACHE_BLOCKS < 1 || SD_CACHE_BLOCKS > 16
+  #error "SD_CACHE_BLOCKS must be between 1 and 16"
+#endif
+#if SD_CACHE_BLOCKS > 1 && (SD_CACHE_FAT_BLOCKS < 1 || SD_CACHE_FAT_BLOCKS >= SD_CACHE_BLOCKS)
+  #error "SD_CACHE_FAT_BLOCKS must be at least 1 and less than SD_CACHE_BLOCKS"
+#endif
+//------------------------------------------------------------------------------
+/**
+   Size in bytes of the free space summary kept by each SdVolume.  The FAT is
+   split into up to 8 * SD_FAT_SUMMARY_BYTES groups of whole FAT blocks, and a
+   bit is set for each group found to have no free clusters, so the cluster
+   allocator can step over it without reading it again.  0 disables it.
+*/
+#ifndef SD_FAT_SUMMARY_BYTES
+  #define SD_FAT_SUMMARY_BYTES 32
+#endif
+#if SD_FAT_SUMMARY_BYTES < 0 || SD_FAT_SUMMARY_BYTES > 1024
+  #error "SD_FAT_SUMMARY_BYTES must be between 0 and 1024"
+#endif
+//------------------------------------------------------------------------------
 // forward declaration since SdVolume is used in SdFile
 class SdVolume;
 //==============================================================================
@@ -151,7 +192,7 @@ uint16_t const FAT_DEFAULT_TIME = (1 << 11);
 class SdFile : public Print {
   public:
     /** Create an instance of SdFile. */
-    SdFile(void) : type_(FAT_FILE_TYPE_CLOSED) {}
+    SdFile(void) : type_(FAT_FILE_TYPE_CLOSED), streamMode_(0) {}
     /**
        writeError is set to true if an error occurs during a write().
        Set writeError to false before calling print() and/or write() and check
@@ -255,6 +296,7 @@ class SdFile : public Print {
       return type_ == FAT_FILE_TYPE_ROOT16 || type_ == FAT_FILE_TYPE_ROOT32;
     }
     void ls(uint8_t flags = 0, uint8_t indent = 0);
+    uint8_t preAllocate(uint32_t size);
     uint8_t makeDir(SdFile *dir, const char *dirName);
     uint8_t open(SdFile *dirFile, uint16_t index, uint8_t oflag);
     uint8_t open(SdFile *dirFile, const char *fileName, uint8_t oflag);
@@ -276,6 +318,9 @@ class SdFile : public Print {
     }
     int16_t read(void *buf, uint16_t nbyte);
     int8_t readDir(dir_t *dir);
+    uint8_t readStreamStart(void);
+    int16_t readStreamBlock(uint8_t *dst);
+    uint8_t readStreamStop(void);
     static uint8_t remove(SdFile *dirFile, const char *fileName);
     uint8_t remove(void);
     /** Set the file's current position to zero. */
@@ -335,6 +380,9 @@ class SdFile : public Print {
     void writeln_P(PGM_P str);
     #endif
     int availableForWrite(void);
+    uint8_t writeStreamStart(void);
+    uint8_t writeStreamBlock(const uint8_t *src);
+    uint8_t writeStreamStop(void);
     //------------------------------------------------------------------------------
     #if ALLOW_DEPRECATED_FUNCTIONS
     // Deprecated functions  - suppress cpplint warnings with NOLINT comment
@@ -445,6 +493,12 @@ class SdFile : public Print {
     uint32_t  fileSize_;      // file size in bytes
     uint32_t  firstCluster_;  // first cluster of file
     SdVolume *vol_;           // volume where file is located
+    uint8_t   streamMode_;    // STREAM_READ or STREAM_WRITE while a multiple block transfer is open
+    uint32_t  streamEndBlock_;  // last block that the stream may access
+
+    // values for streamMode_
+    static uint8_t const STREAM_READ = 1;
+    static uint8_t const STREAM_WRITE = 2;
 
     // private functions
     uint8_t addCluster(void);
@@ -482,14 +536,14 @@ union cache_t {
 class SdVolume {
   public:
     /** Create an instance of SdVolume */
-    SdVolume(void) : allocSearchStart_(2), fatType_(0) {}
+    SdVolume(void) : allocSearchStart_(2), fatType_(0), freeClusters_(-1) {}
     /** Clear the cache and returns a pointer to the cache.  Used by the WaveRP
         recorder to do raw write to the SD card.  Not for normal apps.
     */
     static uint8_t *cacheClear(void) {
       cacheFlush();
-      cacheBlockNumber_ = 0XFFFFFFFF;
-      return cacheBuffer_.data;
+      cacheInvalidate(0, 0XFFFFFFFF);
+      return cacheBuffer_->data;
     }
     /**
        Initialize a FAT volume.  Try partition one first then try super
@@ -540,6 +594,7 @@ class SdVolume {
     uint8_t fatType(void) const {
       return fatType_;
     }
+    int32_t freeClusterCount(void);
     /** \return The number of entries in the root directory for FAT16 volumes. */
     uint32_t rootDirEntryCount(void) const {
       return rootDirEntryCount_;
@@ -575,12 +630,28 @@ class SdVolume {
     static uint8_t const CACHE_FOR_READ = 0;
     // value for action argument in cacheRawBlock to indicate cache dirty
     static uint8_t const CACHE_FOR_WRITE = 1;
+    // option for cacheRawBlock - the block will be overwritten, don't read it
+    static uint8_t const CACHE_OPTION_NO_READ = 2;
+    // option for cacheRawBlock - the block is part of the FAT
+    static uint8_t const CACHE_OPTION_FAT = 4;
+    // value for action argument in cacheRawBlock to get a block to overwrite
+    static uint8_t const CACHE_RESERVE_FOR_WRITE = CACHE_FOR_WRITE | CACHE_OPTION_NO_READ;
 
-    static cache_t cacheBuffer_;        // 512 byte cache for device blocks
-    static uint32_t cacheBlockNumber_;  // Logical number of block in the cache
+    // bits in cacheSlotState_
+    static uint8_t const CACHE_STATE_DIRTY = CACHE_FOR_WRITE;  // block must be written
+    static uint8_t const CACHE_STATE_MIRROR = 2;  // copy in second FAT must be written
+    static uint8_t const CACHE_STATE_FAT = CACHE_OPTION_FAT;  // FAT block, uses FAT slots
+    static uint8_t const CACHE_STATE_VALID = 8;   // slot holds a block
+
+    static cache_t cacheSlot_[SD_CACHE_BLOCKS];        // 512 byte caches for device blocks
+    static uint32_t cacheSlotBlock_[SD_CACHE_BLOCKS];  // Logical number of block in each slot
+    static uint8_t cacheSlotState_[SD_CACHE_BLOCKS];   // See above for state bits
+    static uint8_t cacheSlotAge_[SD_CACHE_BLOCKS];     // 0 for most recently used slot
+    static cache_t *cacheBuffer_;       // most recently used block
+    static uint32_t cacheBlockNumber_;  // Logical number of that block
+    static uint8_t cacheCurrent_;       // slot of that block
+    static uint32_t cacheMirrorOffset_; // blocks from FAT block to its copy, or 0
     static Sd2Card *sdCard_;            // Sd2Card object for cache
-    static uint8_t cacheDirty_;         // cacheFlush() will write block if true
-    static uint32_t cacheMirrorBlock_;  // block number for mirror FAT
     //
     uint32_t allocSearchStart_;   // start cluster for alloc search
     uint8_t blocksPerCluster_;    // cluster size in blocks
@@ -593,6 +664,11 @@ class SdVolume {
     uint8_t fatType_;             // volume type (12, 16, OR 32)
     uint16_t rootDirEntryCount_;  // number of entries in FAT16 root dir
     uint32_t rootDirStart_;       // root start block for FAT16, cluster for FAT32
+    int32_t freeClusters_;        // free clusters, -1 until the FAT has been counted
+    #if SD_FAT_SUMMARY_BYTES
+    uint8_t fatGroupShift_;       // shift to convert cluster number to summary group
+    uint8_t fatFull_[SD_FAT_SUMMARY_BYTES];  // bit set when a group has no free clusters
+    #endif
     //----------------------------------------------------------------------------
     uint8_t allocContiguous(uint32_t count, uint32_t *curCluster);
     uint8_t blockOfCluster(uint32_t position) const {
@@ -604,13 +680,23 @@ class SdVolume {
     uint32_t blockNumber(uint32_t cluster, uint32_t position) const {
       return clusterStartBlock(cluster) + blockOfCluster(position);
     }
+    static uint8_t cacheFind(uint32_t blockNumber);
     static uint8_t cacheFlush(uint8_t blocking = 1);
+    static void cacheInit(void);
+    static void cacheInvalidate(uint32_t firstBlock, uint32_t lastBlock);
     static uint8_t cacheMirrorBlockFlush(uint8_t blocking);
+    static uint8_t cacheNextDirty(uint8_t flag);
     static uint8_t cacheRawBlock(uint32_t blockNumber, uint8_t action);
     static void cacheSetDirty(void) {
-      cacheDirty_ |= CACHE_FOR_WRITE;
+      cacheSlotState_[cacheCurrent_] |= CACHE_STATE_DIRTY;
     }
+    static void cacheUse(uint8_t slot);
+    static uint8_t cacheVictim(uint8_t fat);
+    static uint8_t cacheWriteBack(uint8_t slot);
     static uint8_t cacheZeroBlock(uint32_t blockNumber);
+    static uint8_t isCached(uint32_t blockNumber) {
+      return cacheFind(blockNumber) != SD_CACHE_BLOCKS;
+    }
     uint8_t chainSize(uint32_t beginCluster, uint32_t *size) const;
     uint8_t fatGet(uint32_t cluster, uint32_t *value) const;
     uint8_t fatPut(uint32_t cluster, uint32_t value);
@@ -618,6 +704,20 @@ class SdVolume {
       return fatPut(cluster, 0x0FFFFFFF);
     }
     uint8_t freeChain(uint32_t cluster);
+    #if SD_FAT_SUMMARY_BYTES
+    uint8_t fatGroupFull(uint32_t cluster) const {
+      uint16_t group = cluster >> fatGroupShift_;
+      return fatFull_[group >> 3] & (1 << (group & 7));
+    }
+    void fatGroupSetFull(uint32_t cluster, uint8_t full) {
+      uint16_t group = cluster >> fatGroupShift_;
+      if (full) {
+        fatFull_[group >> 3] |= (1 << (group & 7));
+      } else {
+        fatFull_[group >> 3] &= ~(1 << (group & 7));
+      }
+    }
+    #endif
     uint8_t isEOC(uint32_t cluster) const {
       return  cluster >= (fatType_ == 16 ? FAT16EOC_MIN : FAT32EOC_MIN);
     }
@@ -635,7 +735,7 @@ class SdVolume {
       return sdCard_->isBusy();
     }
     uint8_t isCacheMirrorBlockDirty(void) {
-      return (cacheMirrorBlock_ != 0);
+      return cacheNextDirty(CACHE_STATE_MIRROR) != SD_CACHE_BLOCKS;
     }
 };
 #endif  // SdFat_h
@@ -71,7 +71,7 @@ dir_t *SdFile::cacheDirEntry(uint8_t action) {
   if (!SdVolume::cacheRawBlock(dirBlock_, action)) {
     return NULL;
   }
-  return SdVolume::cacheBuffer_.dir + dirIndex_;
+  return SdVolume::cacheBuffer_->dir + dirIndex_;
 }
 //------------------------------------------------------------------------------
 /**
@@ -83,6 +83,12 @@ dir_t *SdFile::cacheDirEntry(uint8_t action) {
    Reasons for failure include no file is open or an I/O error.
 */
 uint8_t SdFile::close(void) {
+  // finish any multiple block transfer first; sync() needs the card
+  if (streamMode_ == STREAM_WRITE) {
+    writeStreamStop();
+  } else if (streamMode_ == STREAM_READ) {
+    readStreamStop();
+  }
   if (!sync()) {
     return false;
   }
@@ -383,7 +389,7 @@ uint8_t SdFile::makeDir(SdFile *dir, const char *dirName) {
   }
 
   // copy '.' to block
-  memcpy(&SdVolume::cacheBuffer_.dir[0], &d, sizeof(d));
+  memcpy(&SdVolume::cacheBuffer_->dir[0], &d, sizeof(d));
 
   // make entry for '..'
   d.name[1] = '.';
@@ -395,7 +401,7 @@ uint8_t SdFile::makeDir(SdFile *dir, const char *dirName) {
     d.firstClusterHigh = dir->firstCluster_ >> 16;
   }
   // copy '..' to block
-  memcpy(&SdVolume::cacheBuffer_.dir[1], &d, sizeof(d));
+  memcpy(&SdVolume::cacheBuffer_->dir[1], &d, sizeof(d));
 
   // set position after '..'
   curPosition_ = 2 * sizeof(d);
@@ -520,7 +526,7 @@ uint8_t SdFile::open(SdFile *dirFile, const char *fileName, uint8_t oflag) {
 
     // use first entry in cluster
     dirIndex_ = 0;
-    p = SdVolume::cacheBuffer_.dir;
+    p = SdVolume::cacheBuffer_->dir;
   }
   // initialize as empty file
   memset(p, 0, sizeof(dir_t));
@@ -598,7 +604,7 @@ uint8_t SdFile::open(SdFile *dirFile, uint16_t index, uint8_t oflag) {
 // open a cached directory entry. Assumes vol_ is initializes
 uint8_t SdFile::openCachedEntry(uint8_t dirIndex, uint8_t oflag) {
   // location of entry in cache
-  dir_t *p = SdVolume::cacheBuffer_.dir + dirIndex;
+  dir_t *p = SdVolume::cacheBuffer_->dir + dirIndex;
 
   // write or truncate is an error for a directory or read-only file
   if (p->attributes & (DIR_ATT_READ_ONLY | DIR_ATT_DIRECTORY)) {
@@ -684,6 +690,40 @@ uint8_t SdFile::openRoot(SdVolume *vol) {
   return true;
 }
 //------------------------------------------------------------------------------
+/**
+   Allocate a contiguous chain of clusters for an empty file.
+
+   The file size is not changed; the clusters are used as the file grows,
+   either by write() or by writeStreamBlock(), which needs a contiguous file.
+   Any clusters beyond the end of the file when it is closed stay allocated
+   to it until it is truncated, for example with truncate(fileSize()).
+
+   \param[in] size The number of bytes to allocate space for.
+
+   \return The value one, true, is returned for success and
+   the value zero, false, is returned for failure.
+   Reasons for failure include the file is not open for write, is not
+   empty, there is no contiguous free space of this size or an I/O error.
+*/
+uint8_t SdFile::preAllocate(uint32_t size) {
+  if (!isFile() || !(flags_ & O_WRITE) || firstCluster_ != 0 || size == 0) {
+    return false;
+  }
+
+  // calculate number of clusters needed
+  uint32_t count = ((size - 1) >> (vol_->clusterSizeShift_ + 9)) + 1;
+
+  if (!vol_->allocContiguous(count, &firstCluster_)) {
+    firstCluster_ = 0;
+    return false;
+  }
+  curCluster_ = 0;
+
+  // insure sync() will update dir entry
+  flags_ |= F_FILE_DIR_DIRTY;
+  return sync();
+}
+//------------------------------------------------------------------------------
 /** %Print the name field of a directory entry in 8.3 format to Serial.
 
    \param[in] dir The directory structure containing the name.
@@ -811,7 +851,7 @@ int16_t SdFile::read(void *buf, uint16_t nbyte) {
 
     // no buffering needed if n == 512 or user requests no buffering
     if ((unbufferedRead() || n == 512) &&
-        block != SdVolume::cacheBlockNumber_) {
+        !SdVolume::isCached(block)) {
       if (!vol_->readData(block, offset, n, dst)) {
         return -1;
       }
@@ -821,7 +861,7 @@ int16_t SdFile::read(void *buf, uint16_t nbyte) {
       if (!SdVolume::cacheRawBlock(block, SdVolume::CACHE_FOR_READ)) {
         return -1;
       }
-      uint8_t *src = SdVolume::cacheBuffer_.data + offset;
+      uint8_t *src = SdVolume::cacheBuffer_->data + offset;
       uint8_t *end = src + n;
       while (src != end) {
         *dst++ = *src++;
@@ -889,7 +929,100 @@ dir_t *SdFile::readDirCache(void) {
   curPosition_ += 31;
 
   // return pointer to entry
-  return (SdVolume::cacheBuffer_.dir + i);
+  return (SdVolume::cacheBuffer_->dir + i);
+}
+//------------------------------------------------------------------------------
+/**
+   Start reading a contiguous file with a multiple block read (CMD18).
+
+   The file position must be a multiple of 512.  Blocks are then read
+   directly from the card into the caller's buffer with readStreamBlock(),
+   bypassing the volume cache, until readStreamStop() is called.  No other
+   access to the card is allowed in between.
+
+   \return The value one, true, is returned for success and
+   the value zero, false, is returned for failure.
+   Reasons for failure include the file is not open for read, is not
+   contiguous, the position is not on a block boundary or at the end of
+   the file, or an I/O error.
+*/
+uint8_t SdFile::readStreamStart(void) {
+  uint32_t bgnBlock;
+  uint32_t endBlock;
+  if (!isFile() || !(flags_ & O_READ) || streamMode_
+      || (curPosition_ & 0X1FF) || curPosition_ >= fileSize_) {
+    return false;
+  }
+  if (!contiguousRange(&bgnBlock, &endBlock)) {
+    return false;
+  }
+  // the card must have any data still in the cache
+  if (!SdVolume::cacheFlush()) {
+    return false;
+  }
+  // don't read past the last block that has file data in it
+  uint32_t lastBlock = bgnBlock + ((fileSize_ - 1) >> 9);
+  streamEndBlock_ = lastBlock < endBlock ? lastBlock : endBlock;
+  if (!vol_->sdCard_->readStart(bgnBlock + (curPosition_ >> 9))) {
+    return false;
+  }
+  streamMode_ = STREAM_READ;
+  return true;
+}
+//------------------------------------------------------------------------------
+/**
+   Read the next block of a file opened with readStreamStart().
+
+   \param[out] dst Location for 512 bytes of data.  The whole block is
+   always written, even if the file ends part way through it.
+
+   \return The number of bytes of the block that are part of the file,
+   zero at the end of the file, or -1 for an error.  Running past the
+   end of the file's clusters (if the directory entry claims more data
+   than was allocated) is an error, and stops the stream.
+*/
+int16_t SdFile::readStreamBlock(uint8_t *dst) {
+  if (streamMode_ != STREAM_READ) {
+    return -1;
+  }
+  if (curPosition_ >= fileSize_) {
+    return 0;
+  }
+  // file is contiguous, so the block is known from the position; the card
+  // would happily keep going past the end of the file's clusters.
+  if (vol_->clusterStartBlock(firstCluster_) + (curPosition_ >> 9) > streamEndBlock_) {
+    readStreamStop();
+    return -1;
+  }
+  if (!vol_->sdCard_->readData(dst)) {
+    streamMode_ = 0;
+    return -1;
+  }
+  uint16_t n = 512;
+  if ((fileSize_ - curPosition_) < 512) {
+    n = fileSize_ - curPosition_;
+  }
+  curPosition_ += n;
+  return n;
+}
+//------------------------------------------------------------------------------
+/**
+   End a multiple block read started with readStreamStart().
+
+   The file position is left after the last byte read, so ordinary reads
+   can continue from there.
+
+   \return The value one, true, is returned for success and
+   the value zero, false, is returned for failure.
+*/
+uint8_t SdFile::readStreamStop(void) {
+  if (streamMode_ != STREAM_READ) {
+    return false;
+  }
+  streamMode_ = 0;
+  // file is contiguous, so the current cluster can be calculated
+  curCluster_ = curPosition_ ? firstCluster_ + ((curPosition_ - 1) >> (vol_->clusterSizeShift_ + 9)) : 0;
+  return vol_->sdCard_->readStop();
 }
 //------------------------------------------------------------------------------
 /**
@@ -1390,9 +1523,7 @@ size_t SdFile::write(const void *buf, uint16_t nbyte) {
     if (n == 512) {
       // full block - don't need to use cache
       // invalidate cache if block is in cache
-      if (SdVolume::cacheBlockNumber_ == block) {
-        SdVolume::cacheBlockNumber_ = 0XFFFFFFFF;
-      }
+      SdVolume::cacheInvalidate(block, block);
       if (!vol_->writeBlock(block, src, blocking)) {
         goto writeErrorReturn;
       }
@@ -1400,18 +1531,16 @@ size_t SdFile::write(const void *buf, uint16_t nbyte) {
     } else {
       if (blockOffset == 0 && curPosition_ >= fileSize_) {
         // start of new block don't need to read into cache
-        if (!SdVolume::cacheFlush()) {
+        if (!SdVolume::cacheRawBlock(block, SdVolume::CACHE_RESERVE_FOR_WRITE)) {
           goto writeErrorReturn;
         }
-        SdVolume::cacheBlockNumber_ = block;
-        SdVolume::cacheSetDirty();
       } else {
         // rewrite part of block
         if (!SdVolume::cacheRawBlock(block, SdVolume::CACHE_FOR_WRITE)) {
           goto writeErrorReturn;
         }
       }
-      uint8_t *dst = SdVolume::cacheBuffer_.data + blockOffset;
+      uint8_t *dst = SdVolume::cacheBuffer_->data + blockOffset;
       uint8_t *end = dst + n;
       while (dst != end) {
         *dst++ = *src++;
@@ -1525,3 +1654,96 @@ int SdFile::availableForWrite() {
 
   return n;
 }
+//------------------------------------------------------------------------------
+/**
+   Start writing a contiguous file with a multiple block write (CMD25).
+
+   The file must be contiguous, either created with createContiguous() or
+   given its clusters with preAllocate(), and the file position must be a
+   multiple of 512.  Blocks are then written directly from the caller's
+   buffer to the card with writeStreamBlock(), bypassing the volume cache and
+   the FAT, until writeStreamStop() is called.  No other access to the card
+   is allowed in between.  The card is told how many blocks remain in the
+   file, so it can pre-erase them.
+
+   \return The value one, true, is returned for success and
+   the value zero, false, is returned for failure.
+   Reasons for failure include the file is not open for write, is not
+   contiguous, the position is not on a block boundary or is past the
+   allocated space, or an I/O error.
+*/
+uint8_t SdFile::writeStreamStart(void) {
+  uint32_t bgnBlock;
+  uint32_t endBlock;
+  if (!isFile() || !(flags_ & O_WRITE) || streamMode_ || (curPosition_ & 0X1FF)) {
+    return false;
+  }
+  if (!contiguousRange(&bgnBlock, &endBlock)) {
+    return false;
+  }
+  uint32_t block = bgnBlock + (curPosition_ >> 9);
+  if (block > endBlock) {
+    return false;
+  }
+  // write out the directory entry and anything else that is dirty, and make
+  // sure the cache can't hold a stale copy of a block we are about to write.
+  if (!sync()) {
+    return false;
+  }
+  SdVolume::cacheInvalidate(block, endBlock);
+  streamEndBlock_ = endBlock;
+  if (!vol_->sdCard_->writeStart(block, endBlock - block + 1)) {
+    return false;
+  }
+  streamMode_ = STREAM_WRITE;
+  return true;
+}
+//------------------------------------------------------------------------------
+/**
+   Write the next block of a file opened with writeStreamStart().
+
+   \param[in] src 512 bytes of data.
+
+   \return The value one, true, is returned for success and
+   the value zero, false, is returned for failure.
+   Reasons for failure include no stream is open, the preallocated space
+   is full, or an I/O error.
+*/
+uint8_t SdFile::writeStreamBlock(const uint8_t *src) {
+  if (streamMode_ != STREAM_WRITE) {
+    return false;
+  }
+  if (vol_->clusterStartBlock(firstCluster_) + (curPosition_ >> 9) > streamEndBlock_) {
+    return false;
+  }
+  if (!vol_->sdCard_->writeData(src)) {
+    streamMode_ = 0;
+    return false;
+  }
+  curPosition_ += 512;
+  if (curPosition_ > fileSize_) {
+    fileSize_ = curPosition_;
+    flags_ |= F_FILE_DIR_DIRTY;
+  }
+  return true;
+}
+//------------------------------------------------------------------------------
+/**
+   End a multiple block write started with writeStreamStart(), and update the
+   directory entry with the new file size.
+
+   \return The value one, true, is returned for success and
+   the value zero, false, is returned for failure.
+*/
+uint8_t SdFile::writeStreamStop(void) {
+  if (streamMode_ != STREAM_WRITE) {
+    return false;
+  }
+  streamMode_ = 0;
+  // file is contiguous, so the current cluster can be calculated
+  curCluster_ = curPosition_ ? firstCluster_ + ((curPosition_ - 1) >> (vol_->clusterSizeShift_ + 9)) : 0;
+  if (!vol_->sdCard_->writeStop()) {
+    return false;
+  }
+  return sync();
+}
@@ -20,12 +20,16 @@
 #include "SdFat.h"
 //------------------------------------------------------------------------------
 // raw block cache
+cache_t  SdVolume::cacheSlot_[SD_CACHE_BLOCKS];       // 512 byte caches for Sd2Card
+uint32_t SdVolume::cacheSlotBlock_[SD_CACHE_BLOCKS];  // block in each slot
+uint8_t  SdVolume::cacheSlotState_[SD_CACHE_BLOCKS];  // all slots start out empty
+uint8_t  SdVolume::cacheSlotAge_[SD_CACHE_BLOCKS];    // LRU order, set by cacheInit()
+cache_t *SdVolume::cacheBuffer_ = SdVolume::cacheSlot_;  // most recently used slot
 // init cacheBlockNumber_to invalid SD block number
 uint32_t SdVolume::cacheBlockNumber_ = 0XFFFFFFFF;
-cache_t  SdVolume::cacheBuffer_;     // 512 byte cache for Sd2Card
+uint8_t  SdVolume::cacheCurrent_ = 0;
+uint32_t SdVolume::cacheMirrorOffset_ = 0;  // offset to mirror block in second FAT
 Sd2Card *SdVolume::sdCard_;          // pointer to SD card object
-uint8_t  SdVolume::cacheDirty_ = 0;  // cacheFlush() will write block if true
-uint32_t SdVolume::cacheMirrorBlock_ = 0;  // mirror  block for second FAT
 //------------------------------------------------------------------------------
 // find a contiguous group of clusters
 uint8_t SdVolume::allocContiguous(uint32_t count, uint32_t *curCluster) {
@@ -55,6 +59,13 @@ uint8_t SdVolume::allocContiguous(uint32_t count, uint32_t *curCluster) {
   // last cluster of FAT
   uint32_t fatEnd = clusterCount_ + 1;
 
+  #if SD_FAT_SUMMARY_BYTES
+  // last cluster of a summary group
+  uint32_t groupMask = (1UL << fatGroupShift_) - 1;
+  // set when a free cluster is seen in the group being scanned
+  uint8_t groupFree = true;
+  #endif
+
   // search the FAT for free clusters
   for (uint32_t n = 0;; n++, endCluster++) {
     // can't find space checked all clusters
@@ -66,6 +77,24 @@ uint8_t SdVolume::allocContiguous(uint32_t count, uint32_t *curCluster) {
     if (endCluster > fatEnd) {
       bgnCluster = endCluster = 2;
     }
+    #if SD_FAT_SUMMARY_BYTES
+    if ((endCluster & groupMask) == 0 || endCluster == 2) {
+      if (fatGroupFull(endCluster)) {
+        // no free clusters in this group - continue with the next one
+        uint32_t next = (endCluster | groupMask) + 1;
+        if (next > fatEnd) {
+          // the last group is short
+          next = fatEnd + 1;
+        }
+        n += next - endCluster - 1;
+        endCluster = next - 1;
+        bgnCluster = next;
+        continue;
+      }
+      // only a scan from the start of the group can show that it is full
+      groupFree = false;
+    }
+    #endif
     uint32_t f;
     if (!fatGet(endCluster, &f)) {
       return false;
@@ -74,10 +103,20 @@ uint8_t SdVolume::allocContiguous(uint32_t count, uint32_t *curCluster) {
     if (f != 0) {
       // cluster in use try next cluster as bgnCluster
       bgnCluster = endCluster + 1;
+      #if SD_FAT_SUMMARY_BYTES
+      if ((endCluster & groupMask) == groupMask && !groupFree) {
+        fatGroupSetFull(endCluster, true);
+      }
+      #endif
     } else if ((endCluster - bgnCluster + 1) == count) {
       // done - found space
       break;
     }
+    #if SD_FAT_SUMMARY_BYTES
+    else {
+      groupFree = true;
+    }
+    #endif
   }
   // mark end of chain
   if (!fatPutEOC(endCluster)) {
@@ -108,61 +147,178 @@ uint8_t SdVolume::allocContiguous(uint32_t count, uint32_t *curCluster) {
   return true;
 }
 //------------------------------------------------------------------------------
+// return the slot holding blockNumber or SD_CACHE_BLOCKS if it isn't cached
+uint8_t SdVolume::cacheFind(uint32_t blockNumber) {
+  for (uint8_t i = 0; i < SD_CACHE_BLOCKS; i++) {
+    if ((cacheSlotState_[i] & CACHE_STATE_VALID) && cacheSlotBlock_[i] == blockNumber) {
+      return i;
+    }
+  }
+  return SD_CACHE_BLOCKS;
+}
+//------------------------------------------------------------------------------
+// write all dirty blocks, lowest block number first. If not blocking, write
+// only one block and return without waiting for the card.
 uint8_t SdVolume::cacheFlush(uint8_t blocking) {
-  if (cacheDirty_) {
-    if (!sdCard_->writeBlock(cacheBlockNumber_, cacheBuffer_.data, blocking)) {
+  uint8_t slot;
+  while ((slot = cacheNextDirty(CACHE_STATE_DIRTY)) != SD_CACHE_BLOCKS) {
+    if (!sdCard_->writeBlock(cacheSlotBlock_[slot], cacheSlot_[slot].data, blocking)) {
       return false;
     }
-
+    if ((cacheSlotState_[slot] & CACHE_STATE_FAT) && cacheMirrorOffset_) {
+      cacheSlotState_[slot] |= CACHE_STATE_MIRROR;
+    }
+    cacheSlotState_[slot] &= ~CACHE_STATE_DIRTY;
     if (!blocking) {
       return true;
     }
-
-    // mirror FAT tables
-    if (!cacheMirrorBlockFlush(blocking)) {
-      return false;
+  }
+  // mirror FAT tables
+  return cacheMirrorBlockFlush(blocking);
+}
+//------------------------------------------------------------------------------
+// empty the cache - called when a volume is mounted
+void SdVolume::cacheInit(void) {
+  for (uint8_t i = 0; i < SD_CACHE_BLOCKS; i++) {
+    cacheSlotState_[i] = 0;
+    cacheSlotAge_[i] = i;
+  }
+  cacheBlockNumber_ = 0XFFFFFFFF;
+}
+//------------------------------------------------------------------------------
+// forget any cached copies of blocks in a range, without writing them, because
+// they are about to be overwritten on the card.
+void SdVolume::cacheInvalidate(uint32_t firstBlock, uint32_t lastBlock) {
+  for (uint8_t i = 0; i < SD_CACHE_BLOCKS; i++) {
+    if (cacheSlotBlock_[i] >= firstBlock && cacheSlotBlock_[i] <= lastBlock) {
+      cacheSlotState_[i] = 0;
     }
-    cacheDirty_ = 0;
   }
-  return true;
+  if (cacheBlockNumber_ >= firstBlock && cacheBlockNumber_ <= lastBlock) {
+    cacheBlockNumber_ = 0XFFFFFFFF;
+  }
 }
 //------------------------------------------------------------------------------
+// write pending copies of FAT blocks to the second FAT, lowest block first
 uint8_t SdVolume::cacheMirrorBlockFlush(uint8_t blocking) {
-  if (cacheMirrorBlock_) {
-    if (!sdCard_->writeBlock(cacheMirrorBlock_, cacheBuffer_.data, blocking)) {
+  uint8_t slot;
+  while ((slot = cacheNextDirty(CACHE_STATE_MIRROR)) != SD_CACHE_BLOCKS) {
+    if (!sdCard_->writeBlock(cacheSlotBlock_[slot] + cacheMirrorOffset_,
+                             cacheSlot_[slot].data, blocking)) {
       return false;
     }
-    cacheMirrorBlock_ = 0;
+    cacheSlotState_[slot] &= ~CACHE_STATE_MIRROR;
+    if (!blocking) {
+      return true;
+    }
   }
   return true;
 }
 //------------------------------------------------------------------------------
+// return the slot with the lowest block number that has flag set in its
+// state, or SD_CACHE_BLOCKS if there are none.
+uint8_t SdVolume::cacheNextDirty(uint8_t flag) {
+  uint8_t found = SD_CACHE_BLOCKS;
+  for (uint8_t i = 0; i < SD_CACHE_BLOCKS; i++) {
+    if ((cacheSlotState_[i] & flag) &&
+        (found == SD_CACHE_BLOCKS || cacheSlotBlock_[i] < cacheSlotBlock_[found])) {
+      found = i;
+    }
+  }
+  return found;
+}
+//------------------------------------------------------------------------------
 uint8_t SdVolume::cacheRawBlock(uint32_t blockNumber, uint8_t action) {
-  if (cacheBlockNumber_ != blockNumber) {
-    if (!cacheFlush()) {
+  uint8_t slot = cacheFind(blockNumber);
+  if (slot == SD_CACHE_BLOCKS) {
+    slot = cacheVictim(action & CACHE_OPTION_FAT);
+    if (!cacheWriteBack(slot)) {
       return false;
     }
-    if (!sdCard_->readBlock(blockNumber, cacheBuffer_.data)) {
+    cacheSlotState_[slot] = 0;
+    if (slot == cacheCurrent_) {
+      cacheBlockNumber_ = 0XFFFFFFFF;
+    }
+    if (!(action & CACHE_OPTION_NO_READ)) {
+      if (!sdCard_->readBlock(blockNumber, cacheSlot_[slot].data)) {
+        return false;
+      }
+    }
+    cacheSlotBlock_[slot] = blockNumber;
+    cacheSlotState_[slot] = CACHE_STATE_VALID | (action & CACHE_OPTION_FAT);
+  }
+  cacheSlotState_[slot] |= action & CACHE_FOR_WRITE;
+  cacheUse(slot);
+  return true;
+}
+//------------------------------------------------------------------------------
+// make slot the current block and move it to the front of the LRU order
+void SdVolume::cacheUse(uint8_t slot) {
+  uint8_t age = cacheSlotAge_[slot];
+  for (uint8_t i = 0; i < SD_CACHE_BLOCKS; i++) {
+    if (cacheSlotAge_[i] < age) {
+      cacheSlotAge_[i]++;
+    }
+  }
+  cacheSlotAge_[slot] = 0;
+  cacheCurrent_ = slot;
+  cacheBuffer_ = &cacheSlot_[slot];
+  cacheBlockNumber_ = cacheSlotBlock_[slot];
+}
+//------------------------------------------------------------------------------
+// pick the slot to load a block into: an empty one if there is one, otherwise
+// the least recently used one, from the FAT or non-FAT slots as appropriate.
+uint8_t SdVolume::cacheVictim(uint8_t fat) {
+  #if SD_CACHE_BLOCKS > 1
+  uint8_t first = fat ? 0 : SD_CACHE_FAT_BLOCKS;
+  uint8_t end = fat ? SD_CACHE_FAT_BLOCKS : SD_CACHE_BLOCKS;
+  #else
+  (void)fat;
+  uint8_t first = 0;
+  uint8_t end = 1;
+  #endif
+  uint8_t victim = first;
+  for (uint8_t i = first; i < end; i++) {
+    if (!(cacheSlotState_[i] & CACHE_STATE_VALID)) {
+      return i;
+    }
+    if (cacheSlotAge_[i] > cacheSlotAge_[victim]) {
+      victim = i;
+    }
+  }
+  return victim;
+}
+//------------------------------------------------------------------------------
+// write one slot back to the card, and its mirror if it's a FAT block
+uint8_t SdVolume::cacheWriteBack(uint8_t slot) {
+  if (cacheSlotState_[slot] & CACHE_STATE_DIRTY) {
+    if (!sdCard_->writeBlock(cacheSlotBlock_[slot], cacheSlot_[slot].data)) {
+      return false;
+    }
+    if ((cacheSlotState_[slot] & CACHE_STATE_FAT) && cacheMirrorOffset_) {
+      cacheSlotState_[slot] |= CACHE_STATE_MIRROR;
+    }
+    cacheSlotState_[slot] &= ~CACHE_STATE_DIRTY;
+  }
+  if (cacheSlotState_[slot] & CACHE_STATE_MIRROR) {
+    if (!sdCard_->writeBlock(cacheSlotBlock_[slot] + cacheMirrorOffset_, cacheSlot_[slot].data)) {
       return false;
     }
-    cacheBlockNumber_ = blockNumber;
+    cacheSlotState_[slot] &= ~CACHE_STATE_MIRROR;
   }
-  cacheDirty_ |= action;
   return true;
 }
 //------------------------------------------------------------------------------
 // cache a zero block for blockNumber
 uint8_t SdVolume::cacheZeroBlock(uint32_t blockNumber) {
-  if (!cacheFlush()) {
+  if (!cacheRawBlock(blockNumber, CACHE_RESERVE_FOR_WRITE)) {
     return false;
   }
 
-  // loop take less flash than memset(cacheBuffer_.data, 0, 512);
+  // loop take less flash than memset(cacheBuffer_->data, 0, 512);
   for (uint16_t i = 0; i < 512; i++) {
-    cacheBuffer_.data[i] = 0;
+    cacheBuffer_->data[i] = 0;
   }
-  cacheBlockNumber_ = blockNumber;
-  cacheSetDirty();
   return true;
 }
 //------------------------------------------------------------------------------
@@ -187,14 +343,14 @@ uint8_t SdVolume::fatGet(uint32_t cluster, uint32_t *value) const {
   uint32_t lba = fatStartBlock_;
   lba += fatType_ == 16 ? cluster >> 8 : cluster >> 7;
   if (lba != cacheBlockNumber_) {
-    if (!cacheRawBlock(lba, CACHE_FOR_READ)) {
+    if (!cacheRawBlock(lba, CACHE_FOR_READ | CACHE_OPTION_FAT)) {
       return false;
     }
   }
   if (fatType_ == 16) {
-    *value = cacheBuffer_.fat16[cluster & 0XFF];
+    *value = cacheBuffer_->fat16[cluster & 0XFF];
   } else {
-    *value = cacheBuffer_.fat32[cluster & 0X7F] & FAT32MASK;
+    *value = cacheBuffer_->fat32[cluster & 0X7F] & FAT32MASK;
   }
   return true;
 }
@@ -215,32 +371,40 @@ uint8_t SdVolume::fatPut(uint32_t cluster, uint32_t value) {
   uint32_t lba = fatStartBlock_;
   lba += fatType_ == 16 ? cluster >> 8 : cluster >> 7;
 
-  if (lba != cacheBlockNumber_) {
-    if (!cacheRawBlock(lba, CACHE_FOR_READ)) {
-      return false;
-    }
+  if (!cacheRawBlock(lba, CACHE_FOR_WRITE | CACHE_OPTION_FAT)) {
+    return false;
   }
   // store entry
+  uint32_t old;
   if (fatType_ == 16) {
-    cacheBuffer_.fat16[cluster & 0XFF] = value;
+    old = cacheBuffer_->fat16[cluster & 0XFF];
+    cacheBuffer_->fat16[cluster & 0XFF] = value;
   } else {
-    cacheBuffer_.fat32[cluster & 0X7F] = value;
+    old = cacheBuffer_->fat32[cluster & 0X7F] & FAT32MASK;
+    cacheBuffer_->fat32[cluster & 0X7F] = value;
   }
-  cacheSetDirty();
-
-  // mirror second FAT
-  if (fatCount_ > 1) {
-    cacheMirrorBlock_ = lba + blocksPerFat_;
+  // keep the free cluster count, if it is known, and the summary up to date
+  if (freeClusters_ >= 0 && (old == 0) != (value == 0)) {
+    freeClusters_ += value ? -1 : 1;
+  }
+  #if SD_FAT_SUMMARY_BYTES
+  if (value == 0) {
+    fatGroupSetFull(cluster, false);
   }
+  #endif
+  // the copy in the second FAT, if any, is written along with this block,
+  // when the cache flushes it or evicts it to make room for another one.
   return true;
 }
 //------------------------------------------------------------------------------
 // free a cluster chain
 uint8_t SdVolume::freeChain(uint32_t cluster) {
-  // clear free cluster location
-  allocSearchStart_ = 2;
-
   do {
+    // move the search start back to the lowest cluster freed
+    if (cluster < allocSearchStart_) {
+      allocSearchStart_ = cluster;
+    }
+
     uint32_t next;
     if (!fatGet(cluster, &next)) {
       return false;
@@ -257,6 +421,59 @@ uint8_t SdVolume::freeChain(uint32_t cluster) {
   return true;
 }
 //------------------------------------------------------------------------------
+/**
+   Count the free clusters on the volume.  The first call reads the whole FAT,
+   which can take a few seconds on a large card, and fills in the free space
+   summary as it goes.  After that, the count is kept up to date as clusters
+   are allocated and freed, and is returned immediately.
+
+   \return The number of free clusters, or -1 if an I/O error occurs or the
+   volume is FAT12, which isn't supported.
+*/
+int32_t SdVolume::freeClusterCount(void) {
+  if (freeClusters_ >= 0) {
+    return freeClusters_;
+  }
+  if (fatType_ != 16 && fatType_ != 32) {
+    return -1;
+  }
+  uint32_t lastCluster = clusterCount_ + 1;
+  int32_t count = 0;
+  #if SD_FAT_SUMMARY_BYTES
+  uint32_t groupMask = (1UL << fatGroupShift_) - 1;
+  uint8_t groupFree = false;
+  #endif
+  uint32_t cluster = 0;
+  for (uint32_t lba = fatStartBlock_; cluster <= lastCluster; lba++) {
+    if (!cacheRawBlock(lba, CACHE_FOR_READ | CACHE_OPTION_FAT)) {
+      return -1;
+    }
+    // a block holds 256 FAT16 entries or 128 FAT32 entries
+    uint16_t entries = fatType_ == 16 ? 256 : 128;
+    for (uint16_t i = 0; i < entries && cluster <= lastCluster; i++, cluster++) {
+      // the first two entries are reserved
+      if (cluster < 2) {
+        continue;
+      }
+      uint32_t f = fatType_ == 16 ? cacheBuffer_->fat16[i] : cacheBuffer_->fat32[i] & FAT32MASK;
+      if (f == 0) {
+        count++;
+        #if SD_FAT_SUMMARY_BYTES
+        groupFree = true;
+        #endif
+      }
+      #if SD_FAT_SUMMARY_BYTES
+      if ((cluster & groupMask) == groupMask || cluster == lastCluster) {
+        fatGroupSetFull(cluster, !groupFree);
+        groupFree = false;
+      }
+      #endif
+    }
+  }
+  freeClusters_ = count;
+  return count;
+}
+//------------------------------------------------------------------------------
 /**
    Initialize a FAT volume.
 
@@ -275,6 +492,7 @@ uint8_t SdVolume::freeChain(uint32_t cluster) {
 uint8_t SdVolume::init(Sd2Card *dev, uint8_t part) {
   uint32_t volumeStartBlock = 0;
   sdCard_ = dev;
+  cacheInit();
   // if part == 0 assume super floppy with FAT boot sector in block zero
   // if part > 0 assume mbr volume with partition table
   if (part) {
@@ -284,7 +502,7 @@ uint8_t SdVolume::init(Sd2Card *dev, uint8_t part) {
     if (!cacheRawBlock(volumeStartBlock, CACHE_FOR_READ)) {
       return false;
     }
-    part_t *p = &cacheBuffer_.mbr.part[part - 1];
+    part_t *p = &cacheBuffer_->mbr.part[part - 1];
     if ((p->boot & 0X7F) != 0  ||
         p->totalSectors < 100 ||
         p->firstSector == 0) {
@@ -296,7 +514,7 @@ uint8_t SdVolume::init(Sd2Card *dev, uint8_t part) {
   if (!cacheRawBlock(volumeStartBlock, CACHE_FOR_READ)) {
     return false;
   }
-  bpb_t *bpb = &cacheBuffer_.fbs.bpb;
+  bpb_t *bpb = &cacheBuffer_->fbs.bpb;
   if (bpb->bytesPerSector != 512 ||
       bpb->fatCount == 0 ||
       bpb->reservedSectorCount == 0 ||
@@ -320,6 +538,9 @@ uint8_t SdVolume::init(Sd2Card *dev, uint8_t part) {
 
   fatStartBlock_ = volumeStartBlock + bpb->reservedSectorCount;
 
+  // FAT blocks are also written to the second FAT, if there is one
+  cacheMirrorOffset_ = fatCount_ > 1 ? blocksPerFat_ : 0;
+
   // count for FAT16 zero for FAT32
   rootDirEntryCount_ = bpb->rootDirEntryCount;
 
@@ -347,5 +568,31 @@ uint8_t SdVolume::init(Sd2Card *dev, uint8_t part) {
     rootDirStart_ = bpb->fat32RootCluster;
     fatType_ = 32;
   }
+
+  // nothing is known about free space yet
+  allocSearchStart_ = 2;
+  freeClusters_ = -1;
+  #if SD_FAT_SUMMARY_BYTES
+  // smallest group of whole FAT blocks that lets the summary cover the FAT
+  fatGroupShift_ = fatType_ == 16 ? 8 : 7;
+  while ((clusterCount_ + 1) >> fatGroupShift_ >= 8UL * SD_FAT_SUMMARY_BYTES) {
+    fatGroupShift_++;
+  }
+  for (uint16_t i = 0; i < SD_FAT_SUMMARY_BYTES; i++) {
+    fatFull_[i] = 0;
+  }
+  #endif
+
+  // FAT32 keeps a hint for where to look for free clusters in the FSINFO block
+  if (fatType_ == 32 && bpb->fat32FSInfo) {
+    if (!cacheRawBlock(volumeStartBlock + bpb->fat32FSInfo, CACHE_FOR_READ)) {
+      return false;
+    }
+    uint32_t *fsinfo = cacheBuffer_->fat32;
+    if (fsinfo[0] == FSINFO_LEAD_SIG && fsinfo[121] == FSINFO_STRUCT_SIG &&
+        fsinfo[123] >= 2 && fsinfo[123] <= clusterCount_ + 1) {
+      allocSearchStart_ = fsinfo[123];
+    }
+  }
   return true;
 }
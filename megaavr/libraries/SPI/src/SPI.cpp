@@ -507,6 +507,9 @@ void SPIClass::reattachMaskedInterrupts() {
 }
 
 void SPIClass::beginTransaction(SPISettings settings) {
+  #if defined(SPI_ASYNC_ENABLE)
+  flushAsync(); // the last transaction's async transfer, if any, has to finish before anyone else gets the bus.
+  #endif
   if (interruptMode != SPI_IMODE_NONE) {
     if (interruptMode & SPI_IMODE_GLOBAL) {
       noInterrupts();
@@ -518,6 +521,9 @@ void SPIClass::beginTransaction(SPISettings settings) {
 }
 
 void SPIClass::endTransaction(void) {
+  #if defined(SPI_ASYNC_ENABLE)
+  flushAsync();
+  #endif
   if (interruptMode != SPI_IMODE_NONE) {
     if (interruptMode & SPI_IMODE_GLOBAL) {
       interrupts();
@@ -552,6 +558,9 @@ void SPIClass::notUsingInterrupt(uint8_t interruptNumber) {
 }
 
 void SPIClass::beginTransaction(SPISettings settings) {
+  #if defined(SPI_ASYNC_ENABLE)
+  flushAsync(); // the last transaction's async transfer, if any, has to finish before anyone else gets the bus.
+  #endif
   if (interruptMode != SPI_IMODE_NONE) {
     old_sreg = SREG;
     cli(); // NoInterrupts();
@@ -561,6 +570,9 @@ void SPIClass::beginTransaction(SPISettings settings) {
 }
 
 void SPIClass::endTransaction(void) {
+  #if defined(SPI_ASYNC_ENABLE)
+  flushAsync();
+  #endif
   if (in_transaction) {
     in_transaction = 0;
     if (interruptMode != SPI_IMODE_NONE) {
@@ -626,14 +638,120 @@ uint16_t SPIClass::transfer16(uint16_t data) {
   return t.val;
 }
 
+/* Bulk transfers use the buffered mode of the SPI peripheral. With BUFEN set, there is a one byte TX buffer in front of the
+ * shift register, which is signalled by DREIF, and a two byte RX FIFO, signalled by RXCIF, which stays set as long as there is
+ * anything left to read. Calling transfer(uint8_t) in a loop leaves the bus idle while we wait for RXCIF, read the byte and
+ * load the next one - here, the next byte is already waiting in the TX buffer when the current one finishes, so SCK runs
+ * continuously as long as we can keep up (at F_CPU/2, that's 16 system clocks per byte).
+ * We never have more than two bytes that have been written but not read back. That guarantees that the RX FIFO can't
+ * overflow even if an interrupt comes in the middle of a transfer and we get back late, because there can't be more than
+ * two received bytes waiting for us.
+ * CTRLB is put back the way we found it afterwards, so transfer(uint8_t) still works in normal mode, and TXCIF (which is
+ * WRCOL in normal mode) is cleared before we leave buffered mode.
+ */
 void SPIClass::transfer(void *buf, size_t count) {
-  uint8_t *buffer = reinterpret_cast<uint8_t *>(buf);
-  for (size_t i = 0; i < count; i++) {
-    *buffer = transfer(*buffer);
-    buffer++;
+  if (count == 0) {
+    return;
+  }
+  uint8_t *txptr = reinterpret_cast<uint8_t *>(buf);
+  uint8_t *rxptr = txptr;
+  uint8_t *endptr = txptr + count;
+  uint8_t inflight = 0;
+  uint8_t oldctrlb = SPI_MODULE.CTRLB;
+  SPI_MODULE.CTRLB = oldctrlb | SPI_BUFEN_bm;
+  while (SPI_MODULE.INTFLAGS & SPI_RXCIF_bm) {
+    (void)SPI_MODULE.DATA; // nothing should be there, but if there is, it isn't ours.
+  }
+  do {
+    uint8_t flags = SPI_MODULE.INTFLAGS;
+    if (flags & SPI_RXCIF_bm) {
+      *rxptr++ = SPI_MODULE.DATA;
+      inflight--;
+    }
+    // Only our own writes can clear DREIF, so the copy of the flags we read above can't be wrong in the unsafe direction.
+    if ((flags & SPI_DREIF_bm) && inflight < 2 && txptr != endptr) {
+      SPI_MODULE.DATA = *txptr++;
+      inflight++;
+    }
+  } while (rxptr != endptr);
+  SPI_MODULE.INTFLAGS = SPI_TXCIF_bm;
+  SPI_MODULE.CTRLB = oldctrlb;
+}
+
+/* Write-only version: nothing is read back until the end, so all we need to do is write whenever DREIF says there is room.
+ * The RX FIFO overflows, which we don't care about; once the last byte is out (TXCIF) we empty it and clear BUFOVF, so
+ * nothing stale is left lying around for the next transfer. We wait for TXCIF rather than returning as soon as the last
+ * byte is in the buffer because the caller will probably raise CS as soon as we return.
+ */
+void SPIClass::transmit(const void *buf, size_t count) {
+  if (count == 0) {
+    return;
+  }
+  const uint8_t *txptr = reinterpret_cast<const uint8_t *>(buf);
+  const uint8_t *endptr = txptr + count;
+  uint8_t oldctrlb = SPI_MODULE.CTRLB;
+  SPI_MODULE.CTRLB = oldctrlb | SPI_BUFEN_bm;
+  do {
+    while (!(SPI_MODULE.INTFLAGS & SPI_DREIF_bm));
+    SPI_MODULE.DATA = *txptr++;
+  } while (txptr != endptr);
+  // TXCIF may have been set part way through, if an interrupt held us up long enough for the shift register to empty,
+  // so it has to be cleared before we wait for it. Once DREIF says the last byte has moved into the shift register,
+  // that byte takes at least 16 system clocks to go out, so the clear comes before TXCIF is set for it - but only if
+  // nothing gets in between, or the last byte could be out and its TXCIF cleared, and we would wait forever.
+  uint8_t oldSREG = SREG;
+  cli();
+  while (!(SPI_MODULE.INTFLAGS & SPI_DREIF_bm));
+  SPI_MODULE.INTFLAGS = SPI_TXCIF_bm;
+  SREG = oldSREG;
+  while (!(SPI_MODULE.INTFLAGS & SPI_TXCIF_bm));
+  while (SPI_MODULE.INTFLAGS & SPI_RXCIF_bm) {
+    (void)SPI_MODULE.DATA;
   }
+  SPI_MODULE.INTFLAGS = SPI_TXCIF_bm | SPI_BUFOVF_bm;
+  SPI_MODULE.CTRLB = oldctrlb;
 }
 
+/* Read-only version: same as transfer(buf, count), except that we clock out the fill byte instead of loading from the buffer,
+ * so the buffer can be written as we go without caring what was in it. Most devices want 0xFF on MOSI while they talk (SD
+ * cards in particular), hence the default.
+ */
+void SPIClass::receive(void *buf, size_t count, uint8_t fill) {
+  if (count == 0) {
+    return;
+  }
+  uint8_t *rxptr = reinterpret_cast<uint8_t *>(buf);
+  uint8_t *endptr = rxptr + count;
+  size_t tosend = count;
+  uint8_t inflight = 0;
+  uint8_t oldctrlb = SPI_MODULE.CTRLB;
+  SPI_MODULE.CTRLB = oldctrlb | SPI_BUFEN_bm;
+  while (SPI_MODULE.INTFLAGS & SPI_RXCIF_bm) {
+    (void)SPI_MODULE.DATA;
+  }
+  do {
+    uint8_t flags = SPI_MODULE.INTFLAGS;
+    if (flags & SPI_RXCIF_bm) {
+      *rxptr++ = SPI_MODULE.DATA;
+      inflight--;
+    }
+    if ((flags & SPI_DREIF_bm) && inflight < 2 && tosend) {
+      SPI_MODULE.DATA = fill;
+      tosend--;
+      inflight++;
+    }
+  } while (rxptr != endptr);
+  SPI_MODULE.INTFLAGS = SPI_TXCIF_bm;
+  SPI_MODULE.CTRLB = oldctrlb;
+}
+
+#if defined(SPI_ASYNC_ENABLE)
+/* The real one is in SPI_async.cpp, which is only linked if an async transfer can have been started; if it wasn't, there's
+ * never anything to wait for, and this stands in for it so that beginTransaction() and endTransaction() don't pull it in. */
+void __attribute__((weak)) SPIClass::flushAsync() {
+}
+#endif
+
 #if SPI_INTERFACES_COUNT > 0
   SPIClass SPI;
 #endif
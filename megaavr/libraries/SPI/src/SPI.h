@@ -175,6 +175,14 @@
   #define SPI_INTERRUPT_ENABLE      1
 #endif
 
+/* Interrupt driven transfers (transferAsync() and friends) need the SPI interrupt vector(s). Those are in SPI_async.cpp, which
+ * is only linked if the async functions are used, so your own ISR for the SPI interrupt (for example, to use it in slave mode)
+ * is fine as long as you don't use them too. SPI_ASYNC_DISABLE removes them entirely. Like the async stuff in Wire, it is not
+ * available on parts with 8k of flash or less.                                                                               */
+#if !defined(SPI_ASYNC_DISABLE) && (PROGMEM_SIZE > 8192)
+  #define SPI_ASYNC_ENABLE
+#endif
+
 //#define EXTERNAL_NUM_INTERRUPTS   NUM_TOTAL_PINS
 
 class SPISettings {
@@ -280,6 +288,15 @@ class SPIClass {
     byte transfer(uint8_t data);
     uint16_t transfer16(uint16_t data);
     void transfer(void *buf, size_t count);
+    void transmit(const void *buf, size_t count);
+    void receive(void *buf, size_t count, uint8_t fill = 0xFF);
+    #if defined(SPI_ASYNC_ENABLE)
+    // Interrupt driven transfers. Must be called within a transaction. Return false if one is already running or count is 0.
+    bool transferAsync(void *buf, size_t count, void (*callback)(void) = NULL);
+    bool transmitAsync(const void *buf, size_t count, void (*callback)(void) = NULL);
+    bool asyncBusy();
+    void flushAsync();
+    #endif
 
     // Transaction Functions
     void usingInterrupt(uint8_t interruptNumber);
@@ -299,6 +316,9 @@ class SPIClass {
   private:
     void init();
     void config(SPISettings settings);
+    #if defined(SPI_ASYNC_ENABLE)
+    bool startAsync(const uint8_t *txbuf, uint8_t *rxbuf, size_t count, void (*callback)(void));
+    #endif
 
     // These undocumented functions should not be used. except by advanced users
     // SPI.transfer() polls the hardware flag which is automatically cleared as the
@@ -313,6 +333,8 @@ class SPIClass {
     // written interrupt driven system should definitely be viable. At half of *that*, the same interrupt had it been attached() with an
     // attach method that took the function pointer.
     // Using these methods are not recommended, and is not for the feint of heart or dull of mind.
+    // If what you want is to stream a buffer without sitting there waiting for it, use transferAsync() or transmitAsync() - the
+    // SPI interrupt is serviced by a hand-written naked ISR in SPI.cpp, which does not have the overhead described above.
     inline static void attachInterrupt() {
       SPI0.INTCTRL |= (SPI_IE_bm);
     }
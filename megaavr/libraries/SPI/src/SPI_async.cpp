@@ -0,0 +1,256 @@
+/*
+ * SPI Master library for DxCore.
+ * Copyright (c) 2021 Spence Konde, based om earlier version
+ * of SPI.h (c) 2015 Arduino LLC
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+// *INDENT-OFF* astyle hates how we formatted this
+
+/* The interrupt driven transfers, and the SPI ISRs. They're kept out of SPI.cpp so that this file, vectors and all, only
+ * gets linked if transferAsync(), transmitAsync() or asyncBusy() are used, thanks to dot_a_linkage in library.properties.
+ * Otherwise, SPI.cpp's weak do-nothing flushAsync() is used - if this file isn't linked, there's nothing to wait for.
+ */
+
+#include "SPI.h"
+#include <Arduino.h>
+
+#if defined(SPI_ASYNC_ENABLE)
+
+#ifdef SPI1
+  #define SPI_MODULE (*_hwspi_module)
+#else
+  #define SPI_MODULE SPI0
+#endif
+
+  /* State of the async transfer in progress, if any. This is a plain global with C linkage, rather than a member of SPIClass,
+   * so that the ISR can get at it with lds/sts without having to be told where SPI is. The layout is fixed - the offsets
+   * are hardcoded in the assembly below, so don't rearrange it without changing those too.                             */
+  typedef struct {
+    uint8_t *rxptr;             // +0  where the next received byte goes, or NULL to throw it away (transmitAsync)
+    const uint8_t *txptr;       // +2  next byte to send
+    uint16_t txleft;            // +4  bytes not yet written to DATA
+    uint16_t rxleft;            // +6  bytes not yet read back - when this hits 0, we're done.
+    void (*callback)(void);     // +8  called from the ISR when done.
+    uint8_t ctrlb;              // +10 CTRLB to restore when done
+    volatile uint8_t busy;      // +11
+  } spi_async_t;
+
+  extern "C" {
+    spi_async_t _spi_async;
+    void __attribute__((used)) _spi_async_finish(SPI_t *spi);
+  }
+
+  // Called by the ISR once the last byte is in - the bus is idle by then, so we can take it back out of buffered mode.
+  void _spi_async_finish(SPI_t *spi) {
+    spi->INTCTRL &= ~SPI_RXCIE_bm;
+    spi->INTFLAGS = SPI_TXCIF_bm | SPI_BUFOVF_bm;
+    spi->CTRLB = _spi_async.ctrlb;
+    _spi_async.busy = 0;
+    if (_spi_async.callback) {
+      _spi_async.callback();
+    }
+  }
+
+  // C version of the ISR, used by flushAsync() to move things along when interrupts are disabled.
+  static void _spi_async_service(SPI_t *spi) {
+    uint8_t data = spi->DATA;
+    if (_spi_async.txleft) {
+      _spi_async.txleft--;
+      spi->DATA = *_spi_async.txptr++;
+    }
+    if (_spi_async.rxptr) {
+      *_spi_async.rxptr++ = data;
+    }
+    if (--_spi_async.rxleft == 0) {
+      _spi_async_finish(spi);
+    }
+  }
+
+/* Interrupt driven transfers. These use buffered mode like the blocking bulk transfers, and the same rule of at most two bytes
+ * written but not yet read back: we prime the shift register and the TX buffer, and then every time RXCIF fires, we read
+ * a byte and load another one. The next byte is already in the shift register while we do that, so as long as the ISR keeps
+ * up, the bus doesn't go idle.
+ * If interrupts are disabled when this is called (most likely because usingInterrupt() was called, so beginTransaction()
+ * turned them off, and the ISR could not run until endTransaction() anyway), the transfer is done on the spot, by polling,
+ * and the callback is called before we return. That keeps the lockout usingInterrupt() asked for.
+ * Calling it from the callback to chain transfers is fine; the callback is called after the finished transfer is cleaned up.
+ */
+bool SPIClass::startAsync(const uint8_t *txbuf, uint8_t *rxbuf, size_t count, void (*callback)(void)) {
+  if (count == 0 || _spi_async.busy) {
+    return false;
+  }
+  uint8_t oldctrlb = SPI_MODULE.CTRLB;
+  SPI_MODULE.CTRLB = oldctrlb | SPI_BUFEN_bm;
+  while (SPI_MODULE.INTFLAGS & SPI_RXCIF_bm) {
+    (void)SPI_MODULE.DATA;
+  }
+  _spi_async.ctrlb    = oldctrlb;
+  _spi_async.rxptr    = rxbuf;
+  _spi_async.rxleft   = count;
+  _spi_async.callback = callback;
+  _spi_async.busy     = 1;
+  SPI_MODULE.DATA = *txbuf++;
+  count--;
+  if (count) {
+    while (!(SPI_MODULE.INTFLAGS & SPI_DREIF_bm));
+    SPI_MODULE.DATA = *txbuf++;
+    count--;
+  }
+  _spi_async.txptr    = txbuf;
+  _spi_async.txleft   = count;
+  // In an ISR (including the callback of the previous async transfer) the I bit is still set on these parts, and CPUINT.STATUS
+  // keeps the SPI interrupt from running until that ISR returns - but then it will, so that counts as interrupts being on.
+  // Checking CPUINT.STATUS too means that's still the case if the ISR has done a cli().
+  if ((SREG & CPU_I_bm) || (CPUINT.STATUS & (CPUINT_LVL0EX_bm | CPUINT_LVL1EX_bm))) {
+    SPI_MODULE.INTCTRL |= SPI_RXCIE_bm; // If the first byte is already done, this fires right away, which is fine.
+  } else {
+    flushAsync();
+  }
+  return true;
+}
+
+bool SPIClass::transferAsync(void *buf, size_t count, void (*callback)(void)) {
+  return startAsync(reinterpret_cast<const uint8_t *>(buf), reinterpret_cast<uint8_t *>(buf), count, callback);
+}
+
+bool SPIClass::transmitAsync(const void *buf, size_t count, void (*callback)(void)) {
+  return startAsync(reinterpret_cast<const uint8_t *>(buf), NULL, count, callback);
+}
+
+bool SPIClass::asyncBusy() {
+  return _spi_async.busy;
+}
+
+void SPIClass::flushAsync() {
+  while (_spi_async.busy) {
+    if ((!(SREG & CPU_I_bm)) || CPUINT.STATUS) {
+      // Interrupts are off, or we're in an ISR, where the I bit is still set but the SPI ISR can't run until we return.
+      // Either way, we have to do it ourselves or we'd wait forever. Same test as HardwareSerial's _poll_tx_data_empty().
+      if (SPI_MODULE.INTFLAGS & SPI_RXCIF_bm) {
+        _spi_async_service(&SPI_MODULE);
+      }
+    }
+  }
+}
+
+/* The ISR. The vectors just push Z, point it at the SPI module, and jump here, like the USART ones do.
+ * Per byte, from the interrupt to reti is about 105 clocks, of which about 70 are spent in the loop, so an additional
+ * byte handled in the same interrupt (if the next one is done by the time we check) costs 70. At F_CPU/16 (128 clocks per
+ * byte) or slower, the ISR keeps ahead of the bus and the CPU gets a useful fraction of the time back; faster than that,
+ * there will be gaps between bytes, and you may as well use the blocking transfer(). The last byte costs more, since we have to save the call-used registers to call _spi_async_finish().
+ */
+void __attribute__((naked)) __attribute__((used)) __attribute__((noreturn)) _spi_async_isr(void) {
+  __asm__ __volatile__(
+    "_spi_async_isr:"                 "\n\t" // r30 and r31 pushed, Z points to the SPI module.
+      "push       r24"                "\n\t"
+      "in         r24,      0x3F"     "\n\t" // save SREG
+      "push       r24"                "\n\t"
+      "push       r25"                "\n\t"
+      "push       r26"                "\n\t"
+      "push       r27"                "\n\t"
+      "push       r23"                "\n\t"
+    "_spi_async_loop:"                "\n\t"
+      "ldd        r23,     Z + 4"     "\n\t" // SPIn.DATA - read the received byte first, so we never have more than 2 in flight
+      "lds        r24, _spi_async + 4" "\n\t" // txleft
+      "lds        r25, _spi_async + 5" "\n\t"
+      "sbiw       r24,         0"     "\n\t" // anything left to send?
+      "breq  _spi_async_rx"           "\n\t"
+      "sbiw       r24,         1"     "\n\t"
+      "sts  _spi_async + 4,  r24"     "\n\t"
+      "sts  _spi_async + 5,  r25"     "\n\t"
+      "lds        r26, _spi_async + 2" "\n\t" // txptr
+      "lds        r27, _spi_async + 3" "\n\t"
+      "ld         r24,        X+"     "\n\t"
+      "std      Z + 4,       r24"     "\n\t" // next byte into the TX buffer
+      "sts  _spi_async + 2,  r26"     "\n\t"
+      "sts  _spi_async + 3,  r27"     "\n\t"
+    "_spi_async_rx:"                  "\n\t"
+      "lds        r26, _spi_async + 0" "\n\t" // rxptr
+      "lds        r27, _spi_async + 1" "\n\t"
+      "mov        r24,       r26"     "\n\t"
+      "or         r24,       r27"     "\n\t" // NULL means transmitAsync() - throw it away.
+      "breq  _spi_async_count"        "\n\t"
+      "st          X+,       r23"     "\n\t"
+      "sts  _spi_async + 0,  r26"     "\n\t"
+      "sts  _spi_async + 1,  r27"     "\n\t"
+    "_spi_async_count:"               "\n\t"
+      "lds        r24, _spi_async + 6" "\n\t" // rxleft
+      "lds        r25, _spi_async + 7" "\n\t"
+      "sbiw       r24,         1"     "\n\t"
+      "sts  _spi_async + 6,  r24"     "\n\t" // sts doesn't touch SREG, so the breq below still tests the result of the sbiw.
+      "sts  _spi_async + 7,  r25"     "\n\t"
+      "breq  _spi_async_done"         "\n\t"
+      "ldd        r24,     Z + 3"     "\n\t" // SPIn.INTFLAGS
+      "sbrc       r24,         7"     "\n\t" // if RXCIF is set again already, go around again instead of paying for reti
+      "rjmp  _spi_async_loop"         "\n\t" // and another trip through the vector.
+    "_spi_async_end:"                 "\n\t"
+      "pop        r23"                "\n\t"
+      "pop        r27"                "\n\t"
+      "pop        r26"                "\n\t"
+      "pop        r25"                "\n\t"
+      "pop        r24"                "\n\t"
+      "out       0x3F,       r24"     "\n\t" // restore SREG
+      "pop        r24"                "\n\t"
+      "pop        r31"                "\n\t"
+      "pop        r30"                "\n\t"
+      "reti"                          "\n\t"
+    "_spi_async_done:"                "\n\t" // Last byte is in. Save the rest of the call-used registers and call the C code.
+      "push        r0"                "\n\t"
+      "push        r1"                "\n\t"
+      "push       r18"                "\n\t"
+      "push       r19"                "\n\t"
+      "push       r20"                "\n\t"
+      "push       r21"                "\n\t"
+      "push       r22"                "\n\t"
+      "clr         r1"                "\n\t"
+      "movw       r24,       r30"     "\n\t" // the SPI module is the argument
+      "call  _spi_async_finish"       "\n\t"
+      "pop        r22"                "\n\t"
+      "pop        r21"                "\n\t"
+      "pop        r20"                "\n\t"
+      "pop        r19"                "\n\t"
+      "pop        r18"                "\n\t"
+      "pop         r1"                "\n\t"
+      "pop         r0"                "\n\t"
+      "rjmp  _spi_async_end"          "\n\t"
+    ::);
+  __builtin_unreachable();
+}
+
+ISR(SPI0_INT_vect, ISR_NAKED) {
+  __asm__ __volatile__(
+        "push      r30"     "\n\t"
+        "push      r31"     "\n\t"
+        :::);
+  __asm__ __volatile__(
+        "jmp   _spi_async_isr"     "\n\t"
+        ::"z"(&SPI0));
+  __builtin_unreachable();
+}
+
+#if defined(SPI1)
+ISR(SPI1_INT_vect, ISR_NAKED) {
+  __asm__ __volatile__(
+        "push      r30"     "\n\t"
+        "push      r31"     "\n\t"
+        :::);
+  __asm__ __volatile__(
+        "jmp   _spi_async_isr"     "\n\t"
+        ::"z"(&SPI1));
+  __builtin_unreachable();
+}
+#endif
+#endif
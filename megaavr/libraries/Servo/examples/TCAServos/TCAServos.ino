@@ -0,0 +1,39 @@
+/* TCAServos
+  Three servos pulsed by TCA0 itself, and a fourth by the usual interrupt, all sweeping together.
+  The pins are for a 48 or 64-pin DA or DB, where TCA0 is on PORTC; on a 28 or 32-pin part it's on PORTD.
+  See the README for the rest.
+  This example code is in the public domain.
+*/
+
+#include <Servo.h>
+
+Servo tcaServo[3];
+Servo isrServo;
+const uint8_t tcaPins[3] = {PIN_PC0, PIN_PC1, PIN_PC2}; // TCA0 WO0-2
+
+void setup() {
+  if (!Servo::useTCA(TCA0)) {
+    // TCA0 is the millis timer. The servos still work, they just all use the interrupt.
+  }
+  for (uint8_t i = 0; i < 3; i++) {
+    tcaServo[i].attach(tcaPins[i]);
+  }
+  isrServo.attach(PIN_PA7); // not a TCA0 pin
+}
+
+void loop() {
+  for (int pos = 0; pos <= 180; pos++) {
+    for (uint8_t i = 0; i < 3; i++) {
+      tcaServo[i].write(pos);
+    }
+    isrServo.write(pos);
+    delay(15);
+  }
+  for (int pos = 180; pos >= 0; pos--) {
+    for (uint8_t i = 0; i < 3; i++) {
+      tcaServo[i].write(pos);
+    }
+    isrServo.write(pos);
+    delay(15);
+  }
+}
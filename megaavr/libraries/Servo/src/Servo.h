@@ -94,12 +94,13 @@
 #define REFRESH_INTERVAL       20000UL   // minumim time to refresh servos in microseconds - UL is super-important!
 #define SERVOS_PER_TIMER          12     // the maximum number of servos controlled by one timer
 #define INVALID_SERVO            255     // flag indicating an invalid servo index
+#define SERVO_HARDWARE          0x80     // isActive flag for a servo pulsed by a TCA channel; low bits are (TCA number << 2) | channel
 // *INDENT-ON*
 #define MAX_SERVOS (_Nbr_16timers  * SERVOS_PER_TIMER)
 
 
 typedef struct  {       // port & bitmask used instead of pin number to realize dramatic performance boost
-  uint8_t isActive;    // true if this channel is enabled, pin not pulsed if false
+  uint8_t isActive;    // true if this channel is enabled, pin not pulsed if false, SERVO_HARDWARE | channel if a TCA pulses it
   uint8_t port;         // port number (A=0, B=1, and so on)
   uint8_t bitmask;      // port & bitmask used instead of pin number to realize dramatic performance boost
 } ServoPin_t   ;
@@ -120,6 +121,9 @@ class Servo {
     int read();                                 // returns current pulse width as an angle between 0 and 180 degrees
     unsigned int readMicroseconds();            // returns current pulse width in microseconds for this servo (was read_us() in first release)
     bool attached();                            // return true if this servo is attached, otherwise false
+    #if defined(SERVO_TCA_SUPPORT)
+    static bool useTCA(TCA_t &tca);             // hand a TCA over to Servo; servos attached to its WO0-2 pins afterwards are pulsed by it
+    #endif
   private:
     uint8_t servoIndex;                         // index into the channel data for this servo
     int8_t min;                                 // minimum is this value times 4 added to MIN_PULSE_WIDTH
@@ -24,6 +24,12 @@
 #include <Arduino.h>
 #include <Servo.h>
 
+#if defined(CORE_ISR_TIMING) && ((ISR_TIMING_TCB == 0 && defined(USE_TIMERB0)) || (ISR_TIMING_TCB == 1 && defined(USE_TIMERB1)) || \
+    (ISR_TIMING_TCB == 2 && defined(USE_TIMERB2)) || (ISR_TIMING_TCB == 3 && defined(USE_TIMERB3)) || (ISR_TIMING_TCB == 4 && defined(USE_TIMERB4)))
+  // The core steers clear of Servo's TCB unless ISR_TIMING_TCB was picked by hand, or the only other TCB is millis.
+  #error "The core's ISR timing (CORE_ISR_TIMING) is using the same TCB as Servo - define ISR_TIMING_TCB or SERVO_USE_TIMERBn to pick another one."
+#endif
+
 #if (F_CPU > 10000000)
   #define usToTicks(_us)    ((((_us) / 2) * clockCyclesPerMicrosecond()))            // converts microseconds to tick
   #define ticksToUs(_ticks) (((unsigned) (_ticks) * 2) / clockCyclesPerMicrosecond()) // converts from ticks back to microseconds
@@ -47,6 +53,11 @@ uint8_t ServoCount = 0;                                    // the total number o
 #define SERVO_MIN() (MIN_PULSE_WIDTH - this->min * 4)                                               // minimum value in uS for this servo
 #define SERVO_MAX() (MAX_PULSE_WIDTH - this->max * 4)                                               // maximum value in uS for this servo
 
+#if defined(SERVO_TCA_SUPPORT)
+  #define usToTCATicks(_us) ((uint16_t)(((uint32_t)(_us) * (F_CPU / SERVO_TCA_DIV / 1000UL)) / 1000))  // converts microseconds to TCA ticks
+  static uint8_t servoTCAs = 0;                            // bit n set if TCAn has been handed over with useTCA()
+#endif
+
 void ServoHandler(int timer) {
   // SEVENTEEN TICKS (already!)
 
@@ -96,15 +107,20 @@ void ServoHandler(int timer) {
   currentServoIndex[timer]++;
 
   if (SERVO_INDEX(timer, currentServoIndex[timer]) < ServoCount && currentServoIndex[timer] < SERVOS_PER_TIMER) {
+    uint16_t ticks = SERVO(timer, currentServoIndex[timer]).ticks;
     if (SERVO(timer, currentServoIndex[timer]).Pin.isActive == true) {   // check if activated
       // digitalWrite(SERVO(timer, currentServoIndex[timer]).Pin.nbr, HIGH);   // it's an active channel so pulse it high
       ((PORT_t *)&PORTA + SERVO(timer, currentServoIndex[timer]).Pin.port)->OUTSET = SERVO(timer, currentServoIndex[timer]).Pin.bitmask;
       // EIGHTY TICKS
+    } else if (SERVO(timer, currentServoIndex[timer]).Pin.isActive & SERVO_HARDWARE) {
+      // A TCA is pulsing this one, so don't hold up the others for the length of its pulse - just long enough to be sure
+      // we're out of the ISR before the next compare match.
+      ticks = TRIM_DURATION * 4;
     }
 
     // Get the counter value
-    _timer->CCMP = SERVO(timer, currentServoIndex[timer]).ticks;
-    currentCycleTicks += SERVO(timer, currentServoIndex[timer]).ticks;
+    _timer->CCMP = ticks;
+    currentCycleTicks += ticks;
   } else {
     // finished all channels so wait for the refresh period to expire before starting over
     if (currentCycleTicks + 100 < usToTicks(REFRESH_INTERVAL)) {   // let's not bother if it's gonna take less than 100 ticks for the next
@@ -124,7 +140,13 @@ void ServoHandler(int timer) {
 
 /* Defined in ServoTimers.h */
 ISR(SERVO_INT_vect) {
+  #if defined(CORE_ISR_TIMING) // DxCore's isrTimingGet() instrumentation
+  ISR_TIMING_ENTER(ISR_TIMING_SERVO);
   ServoHandler(0);
+  ISR_TIMING_EXIT();
+  #else
+  ServoHandler(0);
+  #endif
 }
 
 static void initISR() {
@@ -157,6 +179,39 @@ static void finISR() {
   _timer->INTCTRL = 0;
 }
 
+#if defined(SERVO_TCA_SUPPORT)
+// Returns the isActive value for a servo on this pin if one of the TCAs handed over to us has a compare output there
+// with the current PORTMUX setting, otherwise 0. In single mode, only WO0-2 are there. For TCA0, they're pins 0-2 of
+// the port it's on. TCA1 has fewer options, some on pins 4-6, and which ones exist depends on the part.
+static uint8_t hardwareChannel(uint8_t port, uint8_t bit) {
+  uint8_t mux = PORTMUX.TCAROUTEA;
+  if ((servoTCAs & 0x01) && bit < 3 && (mux & PORTMUX_TCA0_gm) == port) {
+    return SERVO_HARDWARE | bit;
+  }
+  #if defined(TCA1)
+  if (servoTCAs & 0x02) {
+    static const uint8_t tca1Port[]  = {PB, PC, PE, PG, PA, PD}; // The last two are the EA-series' options
+    static const uint8_t tca1First[] = { 0,  4,  4,  0,  4,  4};
+    mux = (mux & PORTMUX_TCA1_gm) >> PORTMUX_TCA1_gp;
+    if (mux < sizeof(tca1Port) && port == tca1Port[mux] && (uint8_t)(bit - tca1First[mux]) < 3) {
+      return SERVO_HARDWARE | 0x04 | (bit - tca1First[mux]);
+    }
+  }
+  #endif
+  return 0;
+}
+
+static TCA_t *hardwareTimer(uint8_t active) {
+  #if defined(TCA1)
+  if (active & 0x04) {
+    return &TCA1;
+  }
+  #endif
+  (void) active;
+  return &TCA0;
+}
+#endif
+
 static boolean isTimerActive(timer16_Sequence_t timer) {
   // returns true if any servo is active on this timer
   for (uint8_t channel = 0; channel < SERVOS_PER_TIMER; channel++) {
@@ -169,6 +224,39 @@ static boolean isTimerActive(timer16_Sequence_t timer) {
 
 /****************** end of static functions ******************************/
 
+#if defined(SERVO_TCA_SUPPORT)
+/* Take over a TCA (the same as takeOverTCA0() or takeOverTCA1() would - analogWrite() won't use it any more) and set it
+ * to repeat a 20 ms cycle in single mode. Servos attached after this to the pins of its compare channels 0-2 (as
+ * PORTMUX has the TCA now) are pulsed by the timer itself, instead of the TCB interrupt, so their pulses have no jitter
+ * and cost no CPU time between writes. Returns false if it is the millis timer. */
+bool Servo::useTCA(TCA_t &tca) {
+  uint8_t n;
+  if (&tca == &TCA0) {
+    #if defined(MILLIS_USE_TIMERA0)
+    return false;
+    #endif
+    takeOverTCA0();
+    n = 0x01;
+  #if defined(TCA1)
+  } else if (&tca == &TCA1) {
+    #if defined(MILLIS_USE_TIMERA1)
+    return false;
+    #endif
+    takeOverTCA1();
+    n = 0x02;
+  #endif
+  } else {
+    return false;
+  }
+  // takeOver leaves it reset, in single mode, with all the outputs off; attach() turns on the channels it uses.
+  tca.SINGLE.CTRLB = TCA_SINGLE_WGMODE_SINGLESLOPE_gc;
+  tca.SINGLE.PER   = (F_CPU / SERVO_TCA_DIV / 50) - 1;
+  tca.SINGLE.CTRLA = SERVO_TCA_CLKSEL | TCA_SINGLE_ENABLE_bm;
+  servoTCAs |= n;
+  return true;
+}
+#endif
+
 Servo::Servo() {
   if (ServoCount < MAX_SERVOS) {
     this->servoIndex = ServoCount++; // assign a servo index to this instance
@@ -199,6 +287,15 @@ uint8_t Servo::attach(byte pin, int min, int max) {
     // todo min/max check: abs(min - MIN_PULSE_WIDTH) /4 < 128
     this->min  = (MIN_PULSE_WIDTH - min) / 4; // resolution of min/max is 4 uS
     this->max  = (MAX_PULSE_WIDTH - max) / 4;
+    #if defined(SERVO_TCA_SUPPORT)
+    uint8_t hw = hardwareChannel(prt, digitalPinToBitPosition(pin));
+    if (hw) {
+      servos[this->servoIndex].Pin.isActive = hw;
+      writeMicroseconds(readMicroseconds()); // load the compare channel before turning its output on
+      hardwareTimer(hw)->SINGLE.CTRLB |= (TCA_SINGLE_CMP0EN_bm << (hw & 0x03));
+      return this->servoIndex;
+    }
+    #endif
     // initialize the timer if it has not already been initialized
     timer = SERVO_INDEX_TO_TIMER(servoIndex);
     if (isTimerActive(timer) == false) {
@@ -213,6 +310,12 @@ uint8_t Servo::attach(byte pin, int min, int max) {
 void Servo::detach() {
   timer16_Sequence_t timer;
 
+  #if defined(SERVO_TCA_SUPPORT)
+  uint8_t hw = servos[this->servoIndex].Pin.isActive;
+  if (hw & SERVO_HARDWARE) {
+    hardwareTimer(hw)->SINGLE.CTRLB &= ~(TCA_SINGLE_CMP0EN_bm << (hw & 0x03)); // the pin goes back to PORT, which left it low
+  }
+  #endif
   servos[this->servoIndex].Pin.isActive = false;
   timer = SERVO_INDEX_TO_TIMER(servoIndex);
   if (isTimerActive(timer) == false) {
@@ -244,6 +347,13 @@ void Servo::writeMicroseconds(unsigned int value) {
     }
 
 
+    #if defined(SERVO_TCA_SUPPORT)
+    uint8_t hw = servos[channel].Pin.isActive;
+    if (hw & SERVO_HARDWARE) {
+      // Double buffered - the timer picks it up at the end of the cycle, so a pulse is never cut short or stretched.
+      (&(hardwareTimer(hw)->SINGLE.CMP0BUF))[hw & 0x03] = usToTCATicks(value);
+    }
+    #endif
     value = usToTicks(value);
     // convert to ticks BEFORE compensating for interrupt overhead
     value = value - TRIM_DURATION;
@@ -111,6 +111,34 @@ static volatile __attribute__((used))  TCB_t *_timer =
 #endif
 
 
+// On the Dx and Ex-series, the whole TCA is moved by PORTMUX, and the core has takeOverTCAn(), so Servo::useTCA() can
+// give the TCA's three compare channels to servos on its WO0-2 pins, and those get pulsed entirely by the timer.
+// The prescaler is the smallest one that fits the 20 ms refresh interval into the 16-bit period. That's what decides
+// the resolution: from 1 tick per us at 1 MHz to 3 per us at 12, 24 and 48 MHz.
+#if defined(DXCORE) && defined(PORTMUX_TCA0_gm)
+  #define SERVO_TCA_SUPPORT
+  #if   (F_CPU / 50 <= 65536UL)
+    #define SERVO_TCA_DIV       1
+    #define SERVO_TCA_CLKSEL    TCA_SINGLE_CLKSEL_DIV1_gc
+  #elif (F_CPU / 100 <= 65536UL)
+    #define SERVO_TCA_DIV       2
+    #define SERVO_TCA_CLKSEL    TCA_SINGLE_CLKSEL_DIV2_gc
+  #elif (F_CPU / 200 <= 65536UL)
+    #define SERVO_TCA_DIV       4
+    #define SERVO_TCA_CLKSEL    TCA_SINGLE_CLKSEL_DIV4_gc
+  #elif (F_CPU / 400 <= 65536UL)
+    #define SERVO_TCA_DIV       8
+    #define SERVO_TCA_CLKSEL    TCA_SINGLE_CLKSEL_DIV8_gc
+  #elif (F_CPU / 800 <= 65536UL)
+    #define SERVO_TCA_DIV       16
+    #define SERVO_TCA_CLKSEL    TCA_SINGLE_CLKSEL_DIV16_gc
+  #else
+    #define SERVO_TCA_DIV       64
+    #define SERVO_TCA_CLKSEL    TCA_SINGLE_CLKSEL_DIV64_gc
+  #endif
+#endif
+
+
 typedef enum {
   timer0,
   _Nbr_16timers
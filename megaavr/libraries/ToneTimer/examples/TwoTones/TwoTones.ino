@@ -0,0 +1,31 @@
+/* TwoTones
+  Plays a steady 2 kHz beep made by TCB0 itself on its own pin, while TCB1 plays a little tune on another pin by
+  toggling it from its interrupt. Neither stops the other.
+  Connect a piezo buzzer (or a speaker through a resistor) to each pin. Change the pins to suit your part - any pin
+  works for ToneTCB1, but only PIN_TCB0_WO_INIT lets TCB0 make the tone by itself.
+  This example code is in the public domain.
+*/
+
+#include <ToneTimer.h>
+
+const uint8_t beepPin = PIN_TCB0_WO_INIT;
+const uint8_t tunePin = PIN_PA7;
+const unsigned int tune[] = {262, 294, 330, 349, 392, 440, 494, 523};
+
+void setup() {
+  Serial.begin(115200);
+  ToneTCB0.tone(beepPin, 2000);
+  Serial.print("TCB0 beep made by the timer itself: ");
+  Serial.println(ToneTCB0.usingPWM() ? "yes" : "no");
+}
+
+void loop() {
+  for (uint8_t i = 0; i < sizeof(tune) / sizeof(tune[0]); i++) {
+    ToneTCB1.tone(tunePin, tune[i], 200);
+    while (ToneTCB1.isPlaying());
+    delay(50);
+  }
+  ToneTCB0.noTone();
+  delay(1000);
+  ToneTCB0.tone(beepPin, 2000);
+}
@@ -0,0 +1,12 @@
+// ToneTCB0 and its ISR. This file is only linked in if ToneTCB0 is used, thanks to dot_a_linkage set in library.properties,
+// so TCB0's interrupt stays free for anything else otherwise.
+
+#include "ToneTimer.h"
+
+#if defined(TCB0) && !defined(MILLIS_USE_TIMERB0)
+ToneTimer ToneTCB0(0);
+
+ISR(TCB0_INT_vect) {
+  ToneTCB0._handleInterrupt();
+}
+#endif
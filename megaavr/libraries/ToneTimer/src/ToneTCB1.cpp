@@ -0,0 +1,12 @@
+// ToneTCB1 and its ISR. This file is only linked in if ToneTCB1 is used, thanks to dot_a_linkage set in library.properties,
+// so TCB1's interrupt stays free for anything else otherwise.
+
+#include "ToneTimer.h"
+
+#if defined(TCB1) && !defined(MILLIS_USE_TIMERB1)
+ToneTimer ToneTCB1(1);
+
+ISR(TCB1_INT_vect) {
+  ToneTCB1._handleInterrupt();
+}
+#endif
@@ -0,0 +1,12 @@
+// ToneTCB2 and its ISR. This file is only linked in if ToneTCB2 is used, thanks to dot_a_linkage set in library.properties,
+// so TCB2's interrupt stays free for anything else otherwise.
+
+#include "ToneTimer.h"
+
+#if defined(TCB2) && !defined(MILLIS_USE_TIMERB2)
+ToneTimer ToneTCB2(2);
+
+ISR(TCB2_INT_vect) {
+  ToneTCB2._handleInterrupt();
+}
+#endif
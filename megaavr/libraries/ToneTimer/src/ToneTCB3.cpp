@@ -0,0 +1,12 @@
+// ToneTCB3 and its ISR. This file is only linked in if ToneTCB3 is used, thanks to dot_a_linkage set in library.properties,
+// so TCB3's interrupt stays free for anything else otherwise.
+
+#include "ToneTimer.h"
+
+#if defined(TCB3) && !defined(MILLIS_USE_TIMERB3)
+ToneTimer ToneTCB3(3);
+
+ISR(TCB3_INT_vect) {
+  ToneTCB3._handleInterrupt();
+}
+#endif
@@ -0,0 +1,12 @@
+// ToneTCB4 and its ISR. This file is only linked in if ToneTCB4 is used, thanks to dot_a_linkage set in library.properties,
+// so TCB4's interrupt stays free for anything else otherwise.
+
+#include "ToneTimer.h"
+
+#if defined(TCB4) && !defined(MILLIS_USE_TIMERB4)
+ToneTimer ToneTCB4(4);
+
+ISR(TCB4_INT_vect) {
+  ToneTCB4._handleInterrupt();
+}
+#endif
@@ -0,0 +1,198 @@
+/*  OBLIGATORY LEGAL BOILERPLATE
+ This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License as published by the Free Software Foundation;
+ either version 2.1 of the License, or (at your option) any later version. This library is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ See the GNU Lesser General Public License for more details. You should have received a copy of the GNU Lesser General Public License along with this library;
+ if not, write to the Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "ToneTimer.h"
+
+/* The PWM output is used only if there are at least this many timer ticks per cycle, so that the frequency is within
+ * 0.5/64 = 0.8% (about 13 cents) of the one asked for. Below that it's done with the interrupt, like tone() does. */
+#define TONE_PWM_MIN_PERIOD 64
+
+/* The timer table has the pins that init_TCBs() set PORTMUX.TCBROUTEA for, so a TCB's pin there is only right as long
+ * as its bit is still what it was set to then. */
+#define TONE_TCBROUTEA_INIT (0 TONE_TCB0_PINS TONE_TCB1_PINS TONE_TCB2_PINS TONE_TCB3_PINS TONE_TCB4_PINS)
+#if defined(TCB0_PINS)
+  #define TONE_TCB0_PINS | TCB0_PINS
+#else
+  #define TONE_TCB0_PINS
+#endif
+#if defined(TCB1_PINS)
+  #define TONE_TCB1_PINS | TCB1_PINS
+#else
+  #define TONE_TCB1_PINS
+#endif
+#if defined(TCB2_PINS)
+  #define TONE_TCB2_PINS | TCB2_PINS
+#else
+  #define TONE_TCB2_PINS
+#endif
+#if defined(TCB3_PINS)
+  #define TONE_TCB3_PINS | TCB3_PINS
+#else
+  #define TONE_TCB3_PINS
+#endif
+#if defined(TCB4_PINS)
+  #define TONE_TCB4_PINS | TCB4_PINS
+#else
+  #define TONE_TCB4_PINS
+#endif
+
+void ToneTimer::tone(uint8_t pin, unsigned int frequency, unsigned long duration) {
+  if (frequency == 0) {
+    noTone(); // See the comments in the core's tone() - 0 Hz is silence.
+    return;
+  }
+  uint8_t bit_mask = digitalPinToBitMask(pin);
+  if (bit_mask == NOT_A_PIN) {
+    return;
+  }
+
+  // Can the timer make it by itself? Only on its own pin (the one the core's timer table gives, unless PORTMUX has
+  // moved it since), in 8-bit PWM mode, so at most 256 ticks per cycle. The fastest clock that fits gets the most
+  // accurate frequency: the system clock, system clock / 2, or TCA0's clock, as that is set right now.
+  uint8_t clksel  = 0;
+  uint16_t period = 0;
+  if (digitalPinToTimer(pin) == (TIMERB0 + _n) && !((PORTMUX.TCBROUTEA ^ TONE_TCBROUTEA_INIT) & (1 << _n))) {
+    static const uint16_t tcaDiv[] = {1, 2, 4, 8, 16, 64, 256, 1024};
+    uint32_t clock[3] = {F_CPU, F_CPU / 2, 0};
+    if (TCA0.SPLIT.CTRLA & TCA_SPLIT_ENABLE_bm) {
+      clock[2] = F_CPU / tcaDiv[(TCA0.SPLIT.CTRLA & TCA_SPLIT_CLKSEL_gm) >> TCA_SPLIT_CLKSEL_gp];
+    }
+    static const uint8_t clockSel[3] = {TCB_CLKSEL_DIV1_gc, TCB_CLKSEL_DIV2_gc, TCB_CLKSEL_TCA0_gc};
+    for (uint8_t i = 0; i < 3; i++) {
+      uint32_t p = (clock[i] + (frequency >> 1)) / frequency;
+      if (p <= 256) {
+        if (p >= TONE_PWM_MIN_PERIOD) {
+          period = p;
+          clksel = clockSel[i];
+        }
+        break;
+      }
+    }
+  }
+
+  long count;
+  if (duration > 0) {
+    // Toggles, for the interrupt, or whole cycles, which is half that, for PWM. Divide first when it could overflow.
+    if (duration > 65536) {
+      count = (frequency / 5) * (duration / 100);
+    } else {
+      count = (frequency * duration) / 500;
+    }
+    if (period) {
+      count >>= 1;
+    }
+    if (count == 0) {
+      count = 1;
+    }
+  } else {
+    count = -1;
+  }
+
+  uint32_t compare_val = 0;
+  uint8_t cycles = 1;
+  if (!period) {
+    // Same as tone(): toggle once per compare_val + 1 ticks, or once per that many cycles, if it doesn't fit in 16 bits.
+    compare_val = ((F_CPU / frequency) >> 1);
+    clksel = TCB_CLKSEL_DIV1_gc;
+    if (compare_val > 0x10000) {
+      compare_val >>= 1;
+      clksel = TCB_CLKSEL_DIV2_gc;
+    }
+    while ((compare_val > 0x10000) && (cycles < 64)) {
+      compare_val >>= 1;
+      cycles <<= 1;
+    }
+    if (--compare_val > 0xFFFF) {
+      compare_val = 0xFFFF; // not by any stretch of the word a "tone", but do the best we can.
+    }
+  }
+
+  // Stop the timer before changing anything, so the ISR doesn't see it half done.
+  _timer->CTRLA    = 0;
+  _timer->INTCTRL  = 0;
+  _timer->INTFLAGS = 0xFF;
+  if (_pin != pin) {
+    if (_pin != NOT_A_PIN) {
+      _timer->CTRLB  = 0;               // the old pin's output, if it was PWM
+      _port->OUTCLR  = _bitMask;        // and leave it LOW, as it could damage some speakers otherwise
+    }
+    _port    = digitalPinToPortStruct(pin);
+    _bitMask = bit_mask;
+    _port->DIRSET = bit_mask;           // pinMode(pin, OUTPUT);
+  }
+  _port->OUTCLR = bit_mask;             // digitalWrite(pin, LOW) - the last tone may have left it high, if it was on this pin
+  _count = count;
+  _pwm   = period;
+  _pin   = pin;
+  _timer->CNT = 0;
+  if (period) {
+    _timer->CTRLB = TCB_CNTMODE_PWM8_gc | TCB_CCMPEN_bm;
+    _timer->CCMP  = ((period >> 1) << 8) | (period - 1); // written low byte first, so no problems from the errata.
+  } else {
+    _cyclesPerToggle = cycles;
+    _cycleCount      = cycles;
+    _timer->CTRLB    = TCB_CNTMODE_INT_gc;
+    _timer->CCMP     = compare_val;
+  }
+  if (count > 0 || !period) {
+    _timer->INTCTRL = TCB_CAPTEI_bm;    // in PWM mode the flag is set once per cycle, at TOP.
+  }
+  _timer->CTRLA = clksel | TCB_ENABLE_bm;
+}
+
+void ToneTimer::noTone() {
+  uint8_t oldSREG = SREG;
+  cli();
+  if (_pin != NOT_A_PIN) {
+    _stop();
+  }
+  SREG = oldSREG;
+}
+
+bool ToneTimer::isPlaying() {
+  return _pin != NOT_A_PIN;
+}
+
+bool ToneTimer::usingPWM() {
+  return _pin != NOT_A_PIN && _pwm;
+}
+
+uint8_t ToneTimer::getPin() {
+  return _pin;
+}
+
+/* Turn it off and put the timer back the way init() left it, so analogWrite() works on its pin again. */
+void ToneTimer::_stop() {
+  _timer->CTRLA    = 0;
+  _timer->INTCTRL  = 0;
+  _timer->INTFLAGS = 0xFF;
+  _timer->CTRLB    = TCB_CNTMODE_PWM8_gc;  // output off; the pin goes back to the PORT, which has it LOW.
+  _timer->CCMPL    = PWM_TIMER_PERIOD;
+  _timer->CCMPH    = PWM_TIMER_COMPARE;
+  _timer->CTRLA    = TCB_CLKSEL_TCA0_gc | TCB_ENABLE_bm;
+  _port->OUTCLR    = _bitMask;
+  _pin             = NOT_A_PIN;
+}
+
+void ToneTimer::_handleInterrupt() {
+  if (_pwm) {
+    // Only enabled for a tone with a duration - the timer makes the waveform, we just count the cycles.
+    if (--_count == 0) {
+      _stop();
+    }
+  } else if (!(--_cycleCount)) {
+    _cycleCount   = _cyclesPerToggle;
+    _port->OUTTGL = _bitMask;
+    if (_count > 0) {
+      _count--;
+    } else if (_count == 0) {
+      _stop();
+    }
+  }
+  _timer->INTFLAGS = TCB_CAPT_bm;
+}
@@ -0,0 +1,64 @@
+/*  OBLIGATORY LEGAL BOILERPLATE
+ This library is free software; you can redistribute it and/or modify it under the terms of the GNU Lesser General Public License as published by the Free Software Foundation;
+ either version 2.1 of the License, or (at your option) any later version. This library is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ See the GNU Lesser General Public License for more details. You should have received a copy of the GNU Lesser General Public License along with this library;
+ if not, write to the Free Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*//*
+  ToneTimer - one tone() per type B timer, so several can play at once. Based on the core's Tone.cpp, and the plan for
+  this laid out in the comments there: an object for each timer, ToneTCB0.tone() and ToneTCB0.noTone(), each in its own
+  file along with its ISR, so that (with dot_a_linkage) only the timers that the sketch uses get an ISR.
+
+  Each one works the same way as tone(), toggling the pin from the timer's interrupt - except when the pin is that
+  timer's own WO pin, and the frequency can be made within 0.8% from one of the clocks the TCB can use. Then it puts the
+  timer in 8-bit PWM mode, and the timer makes the square wave by itself: without a duration, no interrupt runs at all,
+  and with one, a short one runs once per cycle (rather than twice) to count them down.
+*/
+
+#ifndef TONETIMER_h
+#define TONETIMER_h
+
+#include <Arduino.h>
+
+class ToneTimer {
+  public:
+    ToneTimer(uint8_t n) : _n(n), _timer((TCB_t *)&TCB0 + n) {}
+    // frequency (in hertz) and duration (in milliseconds, 0 for until noTone()), same as tone().
+    void tone(uint8_t pin, unsigned int frequency, unsigned long duration = 0);
+    void noTone();                // stop, whatever pin it's on, and leave that pin low.
+    bool isPlaying();
+    bool usingPWM();              // true if the current tone is made by the timer itself, not the interrupt
+    uint8_t getPin();             // the pin the tone is on, or NOT_A_PIN
+
+    void _handleInterrupt();      // called by the ISR - not for user code
+
+  private:
+    const uint8_t _n;             // the timer number
+    TCB_t * const _timer;
+    volatile uint8_t _pin = NOT_A_PIN;
+    bool _pwm = false;
+    PORT_t *_port;
+    uint8_t _bitMask;
+    volatile long _count;         // toggles (or, with PWM, cycles) left; 0 - stopped, -1 - until noTone()
+    uint8_t _cyclesPerToggle;     // timer cycles per toggle, for frequencies too low for one cycle at DIV2.
+    uint8_t _cycleCount;
+    void _stop();
+};
+
+#if defined(TCB0) && !defined(MILLIS_USE_TIMERB0)
+  extern ToneTimer ToneTCB0;
+#endif
+#if defined(TCB1) && !defined(MILLIS_USE_TIMERB1)
+  extern ToneTimer ToneTCB1;
+#endif
+#if defined(TCB2) && !defined(MILLIS_USE_TIMERB2)
+  extern ToneTimer ToneTCB2;
+#endif
+#if defined(TCB3) && !defined(MILLIS_USE_TIMERB3)
+  extern ToneTimer ToneTCB3;
+#endif
+#if defined(TCB4) && !defined(MILLIS_USE_TIMERB4)
+  extern ToneTimer ToneTCB4;
+#endif
+
+#endif
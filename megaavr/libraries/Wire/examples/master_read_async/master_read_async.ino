@@ -0,0 +1,63 @@
+/* Wire Master Read - interrupt driven
+ *
+ * Demonstrates the non-blocking master methods of the Wire library
+ * Reads data from an I2C/TWI slave device
+ * Refer to the "Wire Slave Write" example for use with this
+ *
+ * Like the Wire Master Read example, this requests 4 bytes from the slave with the
+ * address 0x54 when 'm' or 'M' is received on Serial - but requestFromAsync() returns
+ * right away, and loop() keeps running (and counting) while the transaction happens in
+ * the background. When masterAsyncStatus() is no longer TWI_ASYNC_PENDING, the data
+ * can be read with Wire.read() as usual.
+ *
+ * To use this, you need to connect the SCL and SDA pins of this device to the
+ * SCL and SDA pins of a second device running the Wire Slave Write example.
+ *
+ * Pullup resistors must be connected between both data lines and Vcc.
+ * See the Wire library README.md for more information.
+ */
+
+#define MySerial Serial
+
+#include <Wire.h>
+
+bool waiting = false;
+uint32_t loops = 0;
+
+void setup() {
+  Wire.begin();                                 // initialize master
+  MySerial.begin(115200);
+}
+
+void loop() {
+  if (MySerial.available() > 0) {    // as soon as the first byte is received on Serial
+    char c = MySerial.read();       // read the data from serial.
+    if ((c == 'm' || c == 'M') && !waiting) {
+      if (Wire.requestFromAsync(0x54, 4) == 0) {   // start the request; this does not wait for it.
+        waiting = true;
+        loops = 0;
+      }
+    }
+  }
+  if (waiting) {
+    loops++;
+    uint8_t status = Wire.masterAsyncStatus();
+    if (status != TWI_ASYNC_PENDING) {
+      waiting = false;
+      if (status == 0 && Wire.available() == 4) {
+        uint32_t ms;
+        ms  = (uint32_t)Wire.read();               // read out 32-bit wide data
+        ms |= (uint32_t)Wire.read() <<  8;
+        ms |= (uint32_t)Wire.read() << 16;
+        ms |= (uint32_t)Wire.read() << 24;
+        MySerial.print(ms);                        // print the milliseconds from Slave
+        MySerial.print(" - loop() ran ");
+        MySerial.print(loops);
+        MySerial.println(" times while waiting");
+      } else {
+        MySerial.print("Wire.requestFromAsync() failed, error 0x");
+        MySerial.println(status, HEX);
+      }
+    }
+  }
+}
@@ -483,6 +483,17 @@ void TwoWire::endMaster(void) {
     _module->MCTRLA = 0x00;
     _module->MBAUD  = 0x00;
     _bools._hostEnabled  = 0x00;
+    #if defined(TWI_ASYNC_ENABLE)
+      uint8_t oldSREG = SREG;
+      cli();
+      twiTransaction *trans = _asyncTrans;  // MCTRLA = 0 turned the master interrupts off, so nothing will finish it.
+      if (trans != NULL) {
+        _asyncTrans   = NULL;
+        trans->status = TWI_ERR_UNINIT;
+      }
+      runQueue();                           // fails everything still queued with TWI_ERR_UNINIT
+      SREG = oldSREG;
+    #endif
   }
 }
 
@@ -637,6 +648,13 @@ uint8_t TwoWire::masterReceive(auto *length, uint8_t *buffer, uint8_t addr, uint
   TWI_t *module = _module;
   __asm__ __volatile__("\n\t" : "+z"(module));
 
+  #if defined(TWI_ASYNC_ENABLE)
+    if (_asyncTrans != NULL) {   // an interrupt driven transaction owns the bus
+      *length = 0;
+      return TWI_ERR_BUSY;
+    }
+  #endif
+
   TWIR_INIT_ERROR;             // local variable for errors
   auto dataToRead = *length;
 
@@ -839,6 +857,11 @@ uint8_t TwoWire::masterTransmit(auto *length, uint8_t *buffer, uint8_t addr, uin
   if ((module->MCTRLA & TWI_ENABLE_bm) == 0x00) {  // If the module is disabled, abort
     return TWI_ERR_UNINIT;
   }
+  #if defined(TWI_ASYNC_ENABLE)
+    if (_asyncTrans != NULL) {   // an interrupt driven transaction owns the bus
+      return TWI_ERR_BUSY;
+    }
+  #endif
 
   while (true) {
     currentStatus = module->MSTATUS;
@@ -908,6 +931,329 @@ uint8_t TwoWire::masterTransmit(auto *length, uint8_t *buffer, uint8_t addr, uin
   return TWI_GET_ERROR;
 }
 
+#if defined(TWI_ASYNC_ENABLE)
+/**
+ *@brief      startAsync begins an interrupt driven master transaction
+ *
+ *            Sends the address (with the read bit if there is nothing to write), and turns on
+ *            the master interrupts. HandleMasterIRQ does the rest.
+ *
+ *@param      twiTransaction *trans - the transaction to run
+ *
+ *@return     uint8_t
+ *@retval     TWI_ERR_SUCCESS if it was started, TWI_ERR_BUSY if another one is in progress,
+ *            TWI_ERR_UNINIT if the master is not enabled
+ */
+uint8_t TwoWire::startAsync(twiTransaction *trans) {
+  TWI_t *module = _module;
+  if (((module->MCTRLA & TWI_ENABLE_bm) == 0x00) ||
+      ((module->MSTATUS & TWI_BUSSTATE_gm) == TWI_BUSSTATE_UNKNOWN_gc)) {
+    return TWI_ERR_UNINIT;
+  }
+  uint8_t oldSREG = SREG;
+  cli();
+  if (_asyncTrans != NULL) {
+    SREG = oldSREG;
+    return TWI_ERR_BUSY;
+  }
+  trans->status   = TWI_ASYNC_PENDING;
+  trans->received = 0;
+  _asyncTrans     = trans;
+  _asyncIndex     = 0;
+  uint8_t addr    = trans->address << 1;
+  if ((trans->txLength == 0) && (trans->rxLength != 0)) {
+    _asyncRead    = 1;
+    addr          = ADD_READ_BIT(addr);
+  } else {
+    _asyncRead    = 0;
+  }
+  module->MCTRLA |= TWI_RIEN_bm | TWI_WIEN_bm;
+  module->MADDR   = addr;                     // clears the flags, so the interrupt can't fire until this is sent
+  SREG = oldSREG;
+  return TWI_ERR_SUCCESS;
+}
+
+
+/**
+ *@brief      masterTransaction runs a write-then-read transaction from the master interrupt
+ *
+ *            Returns immediately. Poll trans->status (or masterAsyncStatus()), or use
+ *            onMasterComplete() to be told when it is done. The buffers must not be touched until then.
+ *
+ *@param      twiTransaction *trans - the transaction, see Wire.h
+ *
+ *@return     uint8_t
+ *@retval     see startAsync
+ */
+uint8_t TwoWire::masterTransaction(twiTransaction *trans) {
+  return startAsync(trans);
+}
+
+
+/**
+ *@brief      queueTransaction adds a transaction to the queue, which the master ISR works through
+ *
+ *            Each transaction is started as soon as the previous one finishes, from the ISR, so
+ *            a whole set of them can be run without any involvement from the main loop.
+ *            trans->status is TWI_ASYNC_PENDING from now until that transaction is done.
+ *            The transaction (and its buffers) must stay valid until then.
+ *
+ *@param      twiTransaction *trans - the transaction, see Wire.h
+ *
+ *@return     uint8_t
+ *@retval     TWI_ERR_SUCCESS if it was queued, TWI_ERR_BUSY if the queue is full.
+ */
+uint8_t TwoWire::queueTransaction(twiTransaction *trans) {
+  uint8_t ret = TWI_ERR_SUCCESS;
+  uint8_t oldSREG = SREG;
+  cli();
+  uint8_t head = _queueHead;
+  uint8_t next = (head + 1) & (TWI_QUEUE_DEPTH - 1);
+  if (next == _queueTail) {
+    ret = TWI_ERR_BUSY;
+  } else {
+    trans->status = TWI_ASYNC_PENDING;
+    _queue[head]  = trans;
+    _queueHead    = next;
+    runQueue();
+  }
+  SREG = oldSREG;
+  return ret;
+}
+
+
+/**
+ *@brief      queueTransactions queues an array of transactions - for example, one per sensor
+ *
+ *@param      twiTransaction *list - the first of them
+ *@param      uint8_t count - how many
+ *
+ *@return     uint8_t
+ *@retval     the number that were queued; less than count if the queue filled up.
+ */
+uint8_t TwoWire::queueTransactions(twiTransaction *list, uint8_t count) {
+  uint8_t i = 0;
+  for (; i < count; i++) {
+    if (queueTransaction(list++) != TWI_ERR_SUCCESS) {
+      break;
+    }
+  }
+  return i;
+}
+
+
+/**
+ *@brief      queuedTransactions returns how many transactions are waiting in the queue
+ *
+ *            The one in progress, if any, is not counted. When this is 0 and the last
+ *            status is no longer pending, the queue has been worked through.
+ *
+ *@return     uint8_t
+ */
+uint8_t TwoWire::queuedTransactions(void) {
+  return (_queueHead - _queueTail) & (TWI_QUEUE_DEPTH - 1);
+}
+
+
+/**
+ *@brief      runQueue starts the next queued transaction if the master is free
+ *
+ *            Must be called with interrupts disabled, or from the master ISR.
+ *            If one can't be started (master not enabled), it is marked with the error and skipped.
+ */
+void TwoWire::runQueue(void) {
+  uint8_t tail = _queueTail;
+  while ((tail != _queueHead) && (_asyncTrans == NULL)) {
+    twiTransaction *trans = _queue[tail];
+    uint8_t err = startAsync(trans);
+    if (err == TWI_ERR_BUSY) {
+      break;
+    }
+    tail = (tail + 1) & (TWI_QUEUE_DEPTH - 1);
+    if (err != TWI_ERR_SUCCESS) {
+      trans->status = err;
+    }
+  }
+  _queueTail = tail;
+}
+
+
+/**
+ *@brief      endTransmissionAsync is the non-blocking endTransmission
+ *
+ *            Sends what was written since beginTransmission() from the master interrupt.
+ *            Don't write() to the buffer again until masterAsyncStatus() is no longer TWI_ASYNC_PENDING.
+ *
+ *@param      bool sendStop - if the transaction should be terminated with a STOP condition
+ *
+ *@return     uint8_t
+ *@retval     0 if the transaction was started, otherwise the reason it was not (see startAsync).
+ *            The result of the transaction itself is reported by masterAsyncStatus() and onMasterComplete().
+ */
+uint8_t TwoWire::endTransmissionAsync(bool sendStop) {
+  twiTransaction *trans = &_asyncOwn;
+  if (_asyncTrans == trans) {
+    return TWI_ERR_BUSY;
+  }
+  trans->address  = _clientAddress >> 1;
+  trans->sendStop = sendStop;
+  trans->txBuffer = _hostBuffer;
+  trans->txLength = _bytesToReadWrite;
+  trans->rxLength = 0;
+  return startAsync(trans);
+}
+
+
+/**
+ *@brief      requestFromAsync is the non-blocking requestFrom
+ *
+ *            Once masterAsyncStatus() is no longer TWI_ASYNC_PENDING, the received bytes
+ *            can be read with available()/read() as usual.
+ *
+ *@param      uint8_t address - the address of the client
+ *@param      twi_buf_index_t quantity - the amount of bytes to read, limited to TWI_BUFFER_LENGTH
+ *@param      uint8_t sendStop - if the transaction should be terminated with a STOP condition
+ *
+ *@return     uint8_t
+ *@retval     see endTransmissionAsync
+ */
+uint8_t TwoWire::requestFromAsync(uint8_t address, twi_buf_index_t quantity, uint8_t sendStop) {
+  if (__builtin_constant_p(quantity)) {
+    if (quantity > TWI_BUFFER_LENGTH) {
+      badArg("requestFromAsync requests more bytes then there is Buffer space");
+    }
+  }
+  if (quantity >= TWI_BUFFER_LENGTH) {
+    quantity = TWI_BUFFER_LENGTH;
+  }
+  twiTransaction *trans = &_asyncOwn;
+  if (_asyncTrans == trans) {
+    return TWI_ERR_BUSY;
+  }
+  _clientAddress    = address << 1;
+  _bytesToReadWrite = 0;                      // nothing to read until it's done
+  _bytesReadWritten = 0;
+  trans->address    = address;
+  trans->sendStop   = sendStop;
+  trans->txLength   = 0;
+  trans->rxBuffer   = _hostBuffer;
+  trans->rxLength   = quantity;
+  return startAsync(trans);
+}
+
+
+/**
+ *@brief      masterAsyncStatus returns the state of the last endTransmissionAsync() or requestFromAsync()
+ *
+ *@return     uint8_t
+ *@retval     TWI_ASYNC_PENDING while it is running, afterwards the error code (see endTransmission)
+ */
+uint8_t TwoWire::masterAsyncStatus(void) {
+  return _asyncOwn.status;
+}
+
+
+/**
+ *@brief      onMasterComplete saves the pointer to the function to call when an interrupt driven
+ *            master transaction finishes.
+ *
+ *            It is called from the ISR with the error code, so keep it short.
+ *
+ *@param      void (*function)(uint8_t) - a void returning function that accepts the error code
+ *
+ *@return     void
+ */
+void TwoWire::onMasterComplete(void (*function)(uint8_t)) {
+  user_onMasterComplete = function;
+}
+
+
+/**
+ *@brief      HandleMasterIRQ runs the interrupt driven master transactions
+ *
+ *            Same logic as masterTransmit and masterReceive, one step per interrupt.
+ */
+void TwoWire::HandleMasterIRQ(TwoWire *wire_m) {
+  if (wire_m == NULL) {
+    return;
+  }
+  TWI_t *module = wire_m->_module;
+  twiTransaction *trans = wire_m->_asyncTrans;
+  if (trans == NULL) {                        // nothing to do - blocking transactions don't use the interrupt
+    module->MCTRLA &= ~(TWI_RIEN_bm | TWI_WIEN_bm);
+    return;
+  }
+
+  uint8_t currentStatus = module->MSTATUS;
+  twi_buf_index_t index = wire_m->_asyncIndex;
+  uint8_t error = TWI_ERR_SUCCESS;
+
+  if (currentStatus & (TWI_ARBLOST_bm | TWI_BUSERR_bm)) {
+    error = TWI_ERR_BUS_ARB;
+    module->MSTATUS = TWI_ARBLOST_bm | TWI_BUSERR_bm;
+  } else if (wire_m->_asyncRead == 0) {       // write phase
+    if (!(currentStatus & TWI_WIF_bm)) {
+      return;
+    }
+    if (currentStatus & TWI_RXACK_bm) {       // got a NACK
+      if (index == 0) {                       // to the address
+        error = TWI_ERR_ACK_ADR;
+      } else if (index < trans->txLength) {   // to data, before we were done. A NACK of the last byte is fine
+        error = TWI_ERR_ACK_DAT;
+      }
+    } else if (index < trans->txLength) {
+      module->MDATA = trans->txBuffer[index]; // send the next byte, clears WIF
+      wire_m->_asyncIndex = index + 1;
+      return;
+    }
+    if ((error == TWI_ERR_SUCCESS) && (trans->rxLength != 0)) {
+      wire_m->_asyncRead  = 1;                // written everything, now the read part: repeated start
+      wire_m->_asyncIndex = 0;
+      module->MADDR = ADD_READ_BIT(trans->address << 1);
+      return;
+    }
+    index = 0;                                // nothing was read
+    if ((trans->sendStop != 0) || (error != TWI_ERR_SUCCESS)) {
+      module->MCTRLB = TWI_MCMD_STOP_gc;
+    }
+  } else {                                    // read phase
+    if (currentStatus & TWI_WIF_bm) {         // address NACKed
+      error = TWI_ERR_ACK_ADR;
+      module->MCTRLB = TWI_MCMD_STOP_gc;      // free the bus
+    } else if (currentStatus & TWI_RIF_bm) {
+      trans->rxBuffer[index] = module->MDATA;
+      index++;
+      if (index < trans->rxLength) {
+        module->MCTRLB = TWI_MCMD_RECVTRANS_gc; // ACK, and receive the next one
+        wire_m->_asyncIndex = index;
+        return;
+      }
+      if (trans->sendStop != 0) {
+        module->MCTRLB = TWI_ACKACT_bm | TWI_MCMD_STOP_gc;   // send STOP + NACK
+      } else {
+        module->MCTRLB = TWI_ACKACT_bm;                      // Send NACK, but no STOP
+      }
+    } else {
+      return;
+    }
+  }
+
+  // Done, one way or another. Without a STOP the flags are still set, so the interrupts must go off before we leave.
+  module->MCTRLA &= ~(TWI_RIEN_bm | TWI_WIEN_bm);
+  wire_m->_asyncTrans = NULL;
+  trans->received = index;
+  if (trans == &(wire_m->_asyncOwn)) {
+    wire_m->_bytesToReadWrite = index;        // for available()/read() after requestFromAsync()
+  }
+  trans->status = error;
+  if (wire_m->user_onMasterComplete != NULL) {
+    wire_m->user_onMasterComplete(error);
+  }
+  wire_m->runQueue();                         // and on to the next one, if any
+}
+#endif
+
+
 /**
  *@brief      write fills the transmit buffers, master or slave, depending on when it is called
  *
@@ -1432,6 +1778,25 @@ ISR(TWI0_TWIS_vect) {
 #endif
 
 
+#if defined(TWI_ASYNC_ENABLE)
+  /**
+   *@brief      TWI0 Master Interrupt vector
+   */
+  ISR(TWI0_TWIM_vect) {
+    TwoWire::HandleMasterIRQ(twi0_wire);
+  }
+
+  /**
+   *@brief      TWI1 Master Interrupt vector
+   */
+  #if defined(TWI1)
+    ISR(TWI1_TWIM_vect) {
+      TwoWire::HandleMasterIRQ(twi1_wire);
+    }
+  #endif
+#endif
+
+
 /**
  *@brief      pushSleep and popSleep handle the sleep guard
  *
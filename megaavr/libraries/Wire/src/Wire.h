@@ -136,6 +136,25 @@
 #define  TWI_READ_ERROR_ENABLED   // Enabled on Master Read too
 //#define DISABLE_NEW_ERRORS      // Disables the new error codes and returns TWI_ERR_UNDEFINED instead.
 
+/* Interrupt driven (non-blocking) master transactions. Costs the flash for the master ISR, which is linked in whether
+ * you use it or not, so it's left out on parts with 8k of flash or less. Define TWI_ASYNC_DISABLE for the whole build
+ * (not just in the sketch, since it changes the size of the class) to leave it out elsewhere.
+ */
+#if !defined(TWI_ASYNC_DISABLE) && (PROGMEM_SIZE > 8192)
+  #define  TWI_ASYNC_ENABLE
+#endif
+
+/* Depth of the queue of interrupt driven master transactions (see queueTransaction()). It's a ring of pointers, so it
+ * takes 2 bytes of RAM per entry, per Wire object. Must be a power of two. */
+#if defined(TWI_ASYNC_ENABLE)
+  #if !defined(TWI_QUEUE_DEPTH)
+    #define TWI_QUEUE_DEPTH 8
+  #endif
+  #if (TWI_QUEUE_DEPTH & (TWI_QUEUE_DEPTH - 1)) || (TWI_QUEUE_DEPTH < 2) || (TWI_QUEUE_DEPTH > 128)
+    #error "TWI_QUEUE_DEPTH must be a power of two from 2 to 128"
+  #endif
+#endif
+
 // Errors from Arduino documentation:
 #define  TWI_ERR_SUCCESS         0x00  // Default
 #define  TWI_ERR_DATA_TOO_LONG   0x01  // Not used here; data too long to fit in TX buffer
@@ -151,6 +170,7 @@
   #define  TWI_ERR_BUS_ARB       0x12  // Bus error and/or Arbitration lost
   #define  TWI_ERR_BUF_OVERFLOW  0x13  // Buffer overflow on master read
   #define  TWI_ERR_CLKHLD        0x14  // Something's holding the clock
+  #define  TWI_ERR_BUSY          0x15  // An interrupt driven master transaction is still in progress
 #else
   // DISABLE_NEW_ERRORS can be used to more completely emulate the old error reporting behavior; this should rarely be needed.
   #define  TWI_ERR_UNINIT        TWI_ERR_UNDEFINED  // TWI was in bad state when method was called.
@@ -158,7 +178,10 @@
   #define  TWI_ERR_BUS_ARB       TWI_ERR_UNDEFINED  // Bus error and/or Arbitration lost
   #define  TWI_ERR_BUF_OVERFLOW  TWI_ERR_UNDEFINED  // Buffer overflow on master read
   #define  TWI_ERR_CLKHLD        TWI_ERR_UNDEFINED  // Something's holding the clock
+  #define  TWI_ERR_BUSY          TWI_ERR_UNDEFINED  // An interrupt driven master transaction is still in progress
 #endif
+#define  TWI_ASYNC_PENDING       0x80  // status of an interrupt driven master transaction that hasn't finished yet
+
 
 #if defined(TWI_ERROR_ENABLED)
   #define TWI_ERROR_VAR    twi_error
@@ -204,6 +227,22 @@ struct twiDataBools {         // using a struct so the compiler can use skip if
 
 
 
+/* Describes one interrupt driven master transaction: write txLength bytes from txBuffer, then, if rxLength is not 0,
+ * a repeated start and read rxLength bytes into rxBuffer. Either part may be left out (length 0); with both 0, it just
+ * sends the address, which is handy for probing. The buffers must stay valid until status is no longer TWI_ASYNC_PENDING.
+ */
+struct twiTransaction {
+  uint8_t           address;          // 7-bit address
+  uint8_t           sendStop;         // end with a STOP (otherwise the bus is held for a repeated start)
+  const uint8_t    *txBuffer;
+  twi_buf_index_t   txLength;
+  uint8_t          *rxBuffer;
+  twi_buf_index_t   rxLength;
+  twi_buf_index_t   received;         // set to the number of bytes actually read
+  volatile uint8_t  status;           // TWI_ASYNC_PENDING until done, then the error code (TWI_ERR_SUCCESS = 0)
+};
+
+
 class TwoWire: public Stream {
   private:
     TWI_t *_module;
@@ -229,6 +268,19 @@ class TwoWire: public Stream {
     twi_buf_index_t _bytesReadWrittenS;
     #endif
 
+    #if defined(TWI_ASYNC_ENABLE)
+    twiTransaction * volatile _asyncTrans;   // the transaction the master ISR is working on, NULL if none
+    twi_buf_index_t _asyncIndex;             // bytes written or read so far in this phase
+    uint8_t _asyncRead;                      // 0 = write phase, 1 = read phase
+    twiTransaction _asyncOwn;                // used by endTransmissionAsync() and requestFromAsync()
+    void (*user_onMasterComplete)(uint8_t);
+    twiTransaction *_queue[TWI_QUEUE_DEPTH]; // transactions waiting their turn
+    volatile uint8_t _queueHead;             // next free slot
+    volatile uint8_t _queueTail;             // next one to start
+    uint8_t startAsync(twiTransaction *trans);
+    void    runQueue(void);
+    #endif
+
     uint8_t _hostBuffer[TWI_BUFFER_LENGTH];
     #if defined(TWI_MANDS)
     uint8_t _clientBuffer[TWI_BUFFER_LENGTH];
@@ -263,6 +315,17 @@ class TwoWire: public Stream {
     uint8_t masterTransmit(auto *length, uint8_t *buffer, uint8_t addr, uint8_t sendStop);
     uint8_t masterReceive(auto *length, uint8_t *buffer, uint8_t addr, uint8_t sendStop);
 
+    #if defined(TWI_ASYNC_ENABLE)
+    uint8_t endTransmissionAsync(bool sendStop = true);
+    uint8_t requestFromAsync(uint8_t address, twi_buf_index_t quantity, uint8_t sendStop = 1);
+    uint8_t masterTransaction(twiTransaction *trans);
+    uint8_t masterAsyncStatus(void);
+    uint8_t queueTransaction(twiTransaction *trans);
+    uint8_t queueTransactions(twiTransaction *list, uint8_t count);
+    uint8_t queuedTransactions(void);
+    void    onMasterComplete(void (*)(uint8_t));
+    #endif
+
     virtual size_t write(uint8_t);
     virtual size_t write(const uint8_t *, size_t);
     virtual int available(void);
@@ -303,6 +366,9 @@ class TwoWire: public Stream {
     size_t readBytes(char *data, size_t quantity);
 
     static void HandleSlaveIRQ(TwoWire *wire_s);
+    #if defined(TWI_ASYNC_ENABLE)
+    static void HandleMasterIRQ(TwoWire *wire_m);
+    #endif
 };
 
 
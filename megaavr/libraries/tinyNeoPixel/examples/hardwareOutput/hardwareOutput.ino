@@ -0,0 +1,34 @@
+// tinyNeoPixel_HW - a rainbow that moves while the sketch keeps echoing serial data, which it couldn't do reliably if
+// show() turned interrupts off for the 9 ms it takes to send 300 LEDs. Dx-series only; see the tinyNeoPixel documentation
+// for what it uses. The LEDs have to be on a LUT output pin.
+
+#include <tinyNeoPixel_HW.h>
+
+#define PIN       PIN_PA3 // LUT0 output
+#define NUMPIXELS 300
+
+tinyNeoPixel_HW strip = tinyNeoPixel_HW(NUMPIXELS, PIN, NEO_GRB + NEO_KHZ800);
+
+uint16_t firstHue = 0;
+
+void setup() {
+  Serial.begin(115200);
+  if (!strip.begin()) {
+    Serial.println("Hardware output isn't available on that pin, or something it needs is in use");
+    while (1);
+  }
+  strip.setBrightness(50);
+}
+
+void loop() {
+  while (Serial.available()) {
+    Serial.write(Serial.read());
+  }
+  if (strip.canShow()) { // the last frame is out, so we can change the pixels without it showing up in that one.
+    for (uint16_t i = 0; i < NUMPIXELS; i++) {
+      strip.setPixelColor(i, strip.ColorHSV(firstHue + (i * 65536UL / NUMPIXELS)));
+    }
+    strip.show(); // returns right away.
+    firstHue += 256;
+  }
+}
@@ -0,0 +1,32 @@
+// tinyNeoPixel_Parallel - 8 strips of 150 LEDs on PORTD, all sent at once, so a frame takes 4.5 ms instead of 36.
+// Each strip gets the same rainbow, shifted a bit further along than the one before.
+
+#include <tinyNeoPixel_Parallel.h>
+
+#define NUMPIXELS 150
+const uint8_t pins[] = {PIN_PD0, PIN_PD1, PIN_PD2, PIN_PD3, PIN_PD4, PIN_PD5, PIN_PD6, PIN_PD7};
+#define NUMSTRIPS (sizeof(pins))
+
+tinyNeoPixel_Parallel strips = tinyNeoPixel_Parallel(NUMPIXELS, pins, NUMSTRIPS, NEO_GRB + NEO_KHZ800);
+
+uint16_t firstHue = 0;
+
+void setup() {
+  if (!strips.begin()) {
+    // The pins aren't all on the same port, or there isn't enough RAM for the pixels.
+    pinMode(LED_BUILTIN, OUTPUT);
+    digitalWrite(LED_BUILTIN, HIGH);
+    while (1);
+  }
+}
+
+void loop() {
+  for (uint8_t s = 0; s < NUMSTRIPS; s++) {
+    for (uint16_t i = 0; i < NUMPIXELS; i++) {
+      uint16_t hue = firstHue + s * 4096 + (i * 65536UL / NUMPIXELS);
+      strips.setPixelColor(s, i, tinyNeoPixel::gamma32(tinyNeoPixel::ColorHSV(hue, 255, 64)));
+    }
+  }
+  strips.show();
+  firstHue += 256;
+}
@@ -320,7 +320,7 @@ class tinyNeoPixel {
   #endif
 
 
- private:
+ protected: // tinyNeoPixel_HW.h builds on these
 
   boolean
     begun;         // true if begin() previously called
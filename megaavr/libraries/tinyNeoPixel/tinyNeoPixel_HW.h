@@ -0,0 +1,76 @@
+/*--------------------------------------------------------------------
+  This file is part of the tinyNeoPixel library, derived from
+  Adafruit_NeoPixel.
+
+  NeoPixel is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, either version 3 of
+  the License, or (at your option) any later version.
+
+  NeoPixel is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with NeoPixel.  If not, see
+  <http://www.gnu.org/licenses/>.
+  --------------------------------------------------------------------*/
+
+/* tinyNeoPixel_HW - the same thing as tinyNeoPixel, except that show() has the hardware make the waveform, and
+ * returns as soon as the data is on its way instead of turning off interrupts until the last bit is out. How it works,
+ * what it uses and which pins it can use are in tinyNeoPixel_HWBase.h, which is shared with tinyNeoPixel_Static; all
+ * that's here is the front buffer, which this version allocates.
+ */
+
+#ifndef TINYNEOPIXEL_HW_H
+#define TINYNEOPIXEL_HW_H
+#include "tinyNeoPixel.h"
+#include "tinyNeoPixel_HWBase.h"
+
+class tinyNeoPixel_HW : public tinyNeoPixel_HWBase<tinyNeoPixel> {
+  public:
+    tinyNeoPixel_HW(uint16_t n, uint8_t p, neoPixelType t = NEO_GRB) : tinyNeoPixel_HWBase(n, p, t) {}
+    tinyNeoPixel_HW(void) : tinyNeoPixel_HWBase() {}
+    ~tinyNeoPixel_HW() {
+      flush(); // the front buffer might still be going out.
+      free(_front);
+    }
+
+    /* See tinyNeoPixel_HWBase::show() */
+    void show(uint16_t leds = 0) {
+      if (_front && _frontBytes != numBytes) { // updateLength() or updateType() since useDoubleBuffer()
+        flush();
+        if (!_allocFront()) {
+          return;
+        }
+      }
+      tinyNeoPixel_HWBase::show(leds);
+    }
+
+    /* Send a copy of the pixels instead of the pixels themselves - see show(). The front buffer is allocated here, the
+     * same size as the pixels; returns false if there isn't room for it. From then on, setBrightness() is applied to
+     * the copy as it's made, instead of to the pixels when they're set, so changing it loses nothing, and
+     * setGamma(true) can do the same with gamma8(). If the brightness was set before this, the pixels already
+     * set were scaled by it, and will be scaled again on the way out, so do this first. */
+    bool useDoubleBuffer(void) {
+      flush();
+      if (!_allocFront()) {
+        return false;
+      }
+      _useFront(_front);
+      return true;
+    }
+
+  private:
+    uint16_t _frontBytes = 0;
+
+    bool _allocFront() {
+      free(_front);
+      _front = (uint8_t *)malloc(numBytes);
+      _frontBytes = _front ? numBytes : 0;
+      return _front;
+    }
+};
+
+#endif
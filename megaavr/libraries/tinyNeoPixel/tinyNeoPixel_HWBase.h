@@ -0,0 +1,281 @@
+/*--------------------------------------------------------------------
+  This file is part of the tinyNeoPixel library, derived from
+  Adafruit_NeoPixel.
+
+  NeoPixel is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, either version 3 of
+  the License, or (at your option) any later version.
+
+  NeoPixel is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with NeoPixel.  If not, see
+  <http://www.gnu.org/licenses/>.
+  --------------------------------------------------------------------*/
+
+/* tinyNeoPixel_HWBase - the hardware output behind tinyNeoPixel_HW, in both tinyNeoPixel (tinyNeoPixel_HW.h) and
+ * tinyNeoPixel_Static (tinyNeoPixel_Static_HW.h). Both of those call their class tinyNeoPixel, so this is a template
+ * that derives from whichever one it's given; the tinyNeoPixel_HW classes themselves only add the constructors and the
+ * front buffer for double buffering, which one allocates and the other is handed. Don't include this directly.
+ *
+ * SPI0 clocks the pixel buffer out at around 800 kbit/s (the fastest the prescaler can get without going over it), one
+ * SPI bit per LED bit, fed by the interrupt driven SPI.transmitAsync(). A LUT combines that with a type B timer into the
+ * WS2812 waveform:
+ *
+ *   output = (SCK AND MOSI) OR TCB
+ *
+ * The TCB is in single-shot mode, started by every rising edge of SCK and running for the length of a short (0) high,
+ * about 350 ns. So each bit starts with a rising edge; a 0 ends when the TCB does, and a 1 ends when SCK falls, half way
+ * through the bit. The TCB is started through the event system from the other LUT of the pair, which does nothing but
+ * pass SCK through, since SCK is not otherwise an event generator.
+ *
+ * Uses:
+ *   SPI0, which can't be used for anything else (the LEDs would see it). MOSI and SCK toggle on their pins too.
+ *   TCB0 or TCB1 - begin(1) for TCB1. TCB0 is the default for tone(), and TCB1 for Servo on parts with less than 48 pins.
+ *   Both LUTs of a pair - the one with the LED pin as its output, and the other one in that pair.
+ *   One event channel.
+ *   The LED pin must be a LUT output: Px3, or Px6 (the alternate output) on PORTA, C, D, F, B or G, for LUT0 through
+ *   LUT5 respectively, as far as the part has them. PA6 is SCK unless SPI0 is swapped, so don't use it. PF6, LUT3's
+ *   alternate output, is the reset pin, which can only be an input, so it isn't accepted.
+ *
+ * While a frame is going out, the SPI interrupt runs once per byte (every 10 us) and takes about 105 clocks; anything
+ * else can still run. Another interrupt can hold it off for a while without harm - the LED output just sits low, and as
+ * long as that's shorter than the latch time of the LEDs, they carry on where they left off.
+ * Don't write to the pixels while show() is still sending them, unless you don't mind part of the new frame going out in
+ * the old one; canShow() is true once it's done and the latch time has passed, and flush() waits for that.
+ * useDoubleBuffer() takes care of that at the cost of a second buffer; see there.
+ *
+ * This is all in headers, so that the Logic, Event and SPI libraries only get built for sketches that use it.
+ */
+
+#ifndef TINYNEOPIXEL_HWBASE_H
+#define TINYNEOPIXEL_HWBASE_H
+#include <SPI.h>
+#include <Logic.h>
+#include <Event.h>
+
+#if !defined(SPI_ASYNC_ENABLE)
+  #error "tinyNeoPixel_HW needs SPI.transmitAsync(), which has been turned off with SPI_ASYNC_DISABLE or isn't there on this part."
+#endif
+
+template <class Strip>
+class tinyNeoPixel_HWBase : public Strip {
+  public:
+    using Strip::Strip;
+    ~tinyNeoPixel_HWBase() {
+      flush(); // the pixels might still be going out.
+    }
+
+    /* Set up SPI0, the LUTs, the event channel and the timer (0 = TCB0, 1 = TCB1). Everything else (length, type, pin)
+     * must be set first. This has to be called even with tinyNeoPixel_Static, where the bit-banged begin() does nothing.
+     * Returns false if the pin isn't a LUT output, the timer is used by millis, there's no free event channel, or the
+     * SPI library has been swapped onto SPI1. The whole CCL is disabled for a moment while the LUTs are set up, as it
+     * must be to change them; other LUTs in use will notice that. */
+    bool begin(uint8_t timer = 0) {
+      if (!pixels || (uint8_t)pin >= NUM_DIGITAL_PINS || timer > 1) {
+        return false;
+      }
+      #if defined(MILLIS_USE_TIMERB0)
+        if (timer == 0) return false;
+      #elif defined(MILLIS_USE_TIMERB1)
+        if (timer == 1) return false;
+      #endif
+      static const uint8_t lutByPort[] = {0, 4, 1, 2, 255, 3, 5}; // PORTA through PORTG
+      uint8_t port = digitalPinToPort(pin);
+      uint8_t bit = digitalPinToBitPosition(pin);
+      uint8_t lut = (port < sizeof(lutByPort)) ? lutByPort[port] : 255;
+      #if defined(CCL_TRUTH4)
+        if (lut > 5 || (bit != 3 && bit != 6)) return false;
+      #else
+        if (lut > 3 || (bit != 3 && bit != 6)) return false;
+      #endif
+      if (port == PF && bit == 6) return false; // RESET is input only
+      SPI.begin();
+      SPI.beginTransaction(SPISettings(800000, MSBFIRST, SPI_MODE0));
+      if (!(SPI0.CTRLA & SPI_ENABLE_bm)) {
+        return false; // SPI was swapped to SPI1, and the CCL can only see SPI0.
+      }
+      Event &clock = Event::assign_generator(Event::gen_from_peripheral(CCL, lut ^ 1));
+      if (clock.get_channel_number() == 255) {
+        return false;
+      }
+      TCB_t &tcb = timer ? TCB1 : TCB0;
+      tcb.CTRLA  = 0;
+      tcb.CTRLB  = TCB_CNTMODE_SINGLE_gc;     // WO isn't put out on the pin - the LUT gets it either way.
+      #if (F_CPU >= 6000000UL)
+        tcb.CCMP = (F_CPU / 1000000UL) * 350 / 1000 - 1;
+      #else
+        tcb.CCMP = 1;
+      #endif
+      tcb.CNT    = 0;
+      tcb.EVCTRL = TCB_CAPTEI_bm;             // start on a rising edge
+      tcb.CTRLA  = TCB_CLKSEL_DIV1_gc | TCB_ENABLE_bm;
+      clock.set_user(Event::user_from_peripheral(tcb, 0));
+      clock.start();
+
+      Logic &wave = _logicBlock(lut);
+      Logic &sck  = _logicBlock(lut ^ 1);
+      Logic::stop();
+      // Input 0 and 1 of the SPI input are both MOSI and input 2 is SCK, and the TCB input is the TCB of the same number.
+      wave.enable      = true;
+      wave.input0      = timer ? logic::in::spi : logic::in::tcb;
+      wave.input1      = timer ? logic::in::tcb : logic::in::spi;
+      wave.input2      = logic::in::spi;
+      wave.output      = logic::out::enable;
+      wave.output_swap = (bit == 6) ? logic::out::pin_swap : logic::out::no_swap;
+      wave.truth       = timer ? 0xEC : 0xEA; // TCB, or SCK and MOSI
+      wave.init();
+      sck.enable       = true;
+      sck.input0       = logic::in::masked;
+      sck.input1       = logic::in::masked;
+      sck.input2       = logic::in::spi;
+      sck.output       = logic::out::disable;
+      sck.truth        = 0xF0;                // just SCK
+      sck.init();
+      Logic::start();
+      _begun = true;
+      return true;
+    }
+
+    /* Start sending the pixels (or the first leds of them) and return. Waits first if the last frame isn't done.
+     * With double buffering, the pixels are copied to the front buffer (through gamma and brightness) as soon as the
+     * last frame is out, and it's the copy that gets sent, so the pixels are free to change once this returns. */
+    void show(uint16_t leds = 0) {
+      uint16_t count = numBytes;
+      if (leds && leds < numLEDs) {
+        count = (wOffset == rOffset) ? leds + leds + leds : leds << 2;
+      }
+      if (!_begun || !pixels || !count) {
+        return;
+      }
+      const uint8_t *out = pixels;
+      if (_front) {
+        while (busy());
+        _render(count);
+        out = _front;
+      }
+      while (!canShow());
+      _active = this;
+      SPI.transmitAsync(out, count, _frameDone);
+    }
+
+    void setBrightness(uint8_t b) {
+      if (_front) {
+        _outBrightness = b + 1;
+      } else {
+        Strip::setBrightness(b);
+      }
+    }
+
+    uint8_t getBrightness(void) const {
+      return _front ? _outBrightness - 1 : Strip::getBrightness();
+    }
+
+    /* Apply gamma8() to every byte on the way out. Only with double buffering. */
+    void setGamma(bool on) {
+      _gamma = on;
+    }
+
+    /* True when nothing is being sent and the latch time since the last frame has passed. */
+    bool canShow(void) {
+      if (SPI.asyncBusy()) {
+        return false;
+      }
+      #if (!defined(MILLIS_USE_TIMERNONE) && !defined(MILLIS_USE_TIMERRTC) && !defined(MILLIS_USE_TIMERRTC_XTAL) && !defined(MILLIS_USE_TIMERRTC_XOSC))
+        uint8_t oldSREG = SREG;
+        cli();
+        uint32_t end = endTime; // written by _frameDone() from the ISR.
+        SREG = oldSREG;
+        return (micros() - end) >= (uint32_t) latchTime;
+      #else
+        return true;
+      #endif
+    }
+
+    /* True while a frame is being sent. */
+    bool busy(void) {
+      return SPI.asyncBusy();
+    }
+
+    /* Wait until the frame being sent is done. */
+    void flush(void) {
+      SPI.flushAsync();
+    }
+
+  protected:
+    using Strip::numLEDs;
+    using Strip::numBytes;
+    using Strip::latchTime;
+    using Strip::pin;
+    using Strip::brightness;
+    using Strip::pixels;
+    using Strip::rOffset;
+    using Strip::wOffset;
+    using Strip::endTime;
+
+    uint8_t *_front = NULL;      // what's being sent, with double buffering - owned by the subclass
+    uint8_t _outBrightness = 0;  // like brightness: value + 1, 0 for full
+
+    /* For useDoubleBuffer(), once front is the same size as the pixels: the brightness moves to the way out. */
+    void _useFront(uint8_t *front) {
+      _front = front;
+      _outBrightness = brightness; // stored the same way - value + 1, 0 for full
+      brightness = 0;              // so setPixelColor() stores colors as given
+    }
+
+  private:
+    static inline tinyNeoPixel_HWBase *_active = NULL;
+    bool _begun = false;
+    bool _gamma = false;
+
+    void _render(uint16_t count) {
+      const uint8_t *src = pixels;
+      uint8_t *dest = _front;
+      uint8_t b = _outBrightness;
+      if (!b && !_gamma) {
+        memcpy(dest, src, count);
+        return;
+      }
+      while (count--) {
+        uint8_t c = *src++;
+        if (_gamma) {
+          c = Strip::gamma8(c);
+        }
+        if (b) {
+          c = (c * b) >> 8;
+        }
+        *dest++ = c;
+      }
+    }
+
+    static void _frameDone() {
+      #if (!defined(MILLIS_USE_TIMERNONE) && !defined(MILLIS_USE_TIMERRTC) && !defined(MILLIS_USE_TIMERRTC_XTAL) && !defined(MILLIS_USE_TIMERRTC_XOSC))
+        _active->endTime = micros();
+      #endif
+    }
+
+    static Logic &_logicBlock(uint8_t n) {
+      switch (n) {
+        #if defined(CCL_TRUTH4)
+        case 5:
+          return Logic5;
+        case 4:
+          return Logic4;
+        #endif
+        case 3:
+          return Logic3;
+        case 2:
+          return Logic2;
+        case 1:
+          return Logic1;
+        default:
+          return Logic0;
+      }
+    }
+};
+
+#endif
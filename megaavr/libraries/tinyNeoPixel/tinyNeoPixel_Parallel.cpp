@@ -0,0 +1,201 @@
+/*-------------------------------------------------------------------------
+  This file is part of the tinyNeoPixel library derived from
+  Adafruit_NeoPixel.
+
+  NeoPixel is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, either version 3 of
+  the License, or (at your option) any later version.
+
+  NeoPixel is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with NeoPixel.  If not, see
+  <http://www.gnu.org/licenses/>.
+  -------------------------------------------------------------------------*/
+
+#include "tinyNeoPixel_Parallel.h"
+
+tinyNeoPixel_Parallel::tinyNeoPixel_Parallel(uint16_t n, const uint8_t *pins, uint8_t numStrips, neoPixelType t) :
+  numLEDs(n), latchTime(50), strips(0), port(NOT_A_PORT), portMask(0), slices(NULL), endTime(0) {
+  wOffset = (t >> 6) & 0b11; // See notes in tinyNeoPixel.h
+  rOffset = (t >> 4) & 0b11;
+  gOffset = (t >> 2) & 0b11;
+  bOffset =  t       & 0b11;
+  numBytes = n * ((wOffset == rOffset) ? 3 : 4);
+  if (numStrips > 8 || numBytes > 0x1FFF) {
+    return;
+  }
+  for (uint8_t i = 0; i < numStrips; i++) {
+    uint8_t p = digitalPinToPort(pins[i]);
+    uint8_t m = digitalPinToBitMask(pins[i]);
+    if (p == NOT_A_PORT || (i && p != port) || (portMask & m)) {
+      return; // not a pin, not on the same port as the others, or used twice
+    }
+    port = p;
+    portMask |= m;
+    stripMask[i] = m;
+  }
+  if ((slices = (uint8_t *)malloc(numBytes * 8))) {
+    memset(slices, 0, numBytes * 8);
+    strips = numStrips;
+  }
+}
+
+tinyNeoPixel_Parallel::~tinyNeoPixel_Parallel() {
+  free(slices);
+}
+
+bool tinyNeoPixel_Parallel::begin(void) {
+  if (!strips) {
+    return false;
+  }
+  PORT_t *p = portToPortStruct(port);
+  p->OUTCLR = portMask;
+  p->DIRSET = portMask;
+  return true;
+}
+
+void tinyNeoPixel_Parallel::updateLatch(uint16_t us) {
+  latchTime = (us < 6 ? 6 : us);
+}
+
+/* Each byte of pixel data becomes 8 bytes of slices, MSB first, and the bit for a strip is its pin's bit in them. */
+static void _sliceByte(uint8_t *p, uint8_t mask, uint8_t value) {
+  uint8_t notmask = ~mask;
+  for (uint8_t bit = 0x80; bit; bit >>= 1) {
+    if (value & bit) {
+      *p |= mask;
+    } else {
+      *p &= notmask;
+    }
+    p++;
+  }
+}
+
+static uint8_t _unsliceByte(const uint8_t *p, uint8_t mask) {
+  uint8_t value = 0;
+  for (uint8_t i = 0; i < 8; i++) {
+    value <<= 1;
+    if (*p++ & mask) {
+      value |= 1;
+    }
+  }
+  return value;
+}
+
+void tinyNeoPixel_Parallel::setPixelColor(uint8_t strip, uint16_t n, uint8_t r, uint8_t g, uint8_t b) {
+  if (strip < strips && n < numLEDs) {
+    uint8_t *p = &slices[n * ((wOffset == rOffset) ? 24 : 32)];
+    uint8_t m = stripMask[strip];
+    _sliceByte(p + (rOffset << 3), m, r);
+    _sliceByte(p + (gOffset << 3), m, g);
+    _sliceByte(p + (bOffset << 3), m, b);
+  }
+}
+
+void tinyNeoPixel_Parallel::setPixelColor(uint8_t strip, uint16_t n, uint8_t r, uint8_t g, uint8_t b, uint8_t w) {
+  if (strip < strips && n < numLEDs) {
+    setPixelColor(strip, n, r, g, b);
+    if (wOffset != rOffset) {
+      _sliceByte(&slices[(n * 32) + (wOffset << 3)], stripMask[strip], w);
+    }
+  }
+}
+
+void tinyNeoPixel_Parallel::setPixelColor(uint8_t strip, uint16_t n, uint32_t c) {
+  setPixelColor(strip, n, (uint8_t)(c >> 16), (uint8_t)(c >> 8), (uint8_t)c, (uint8_t)(c >> 24));
+}
+
+uint32_t tinyNeoPixel_Parallel::getPixelColor(uint8_t strip, uint16_t n) const {
+  if (strip >= strips || n >= numLEDs) {
+    return 0;
+  }
+  uint8_t m = stripMask[strip];
+  const uint8_t *p = &slices[n * ((wOffset == rOffset) ? 24 : 32)];
+  uint32_t c = ((uint32_t)_unsliceByte(p + (rOffset << 3), m) << 16) |
+               ((uint32_t)_unsliceByte(p + (gOffset << 3), m) <<  8) |
+                          _unsliceByte(p + (bOffset << 3), m);
+  if (wOffset != rOffset) {
+    c |= (uint32_t)_unsliceByte(p + (wOffset << 3), m) << 24;
+  }
+  return c;
+}
+
+void tinyNeoPixel_Parallel::clear(void) {
+  if (slices) {
+    memset(slices, 0, numBytes * 8);
+  }
+}
+
+/* Bit timing, in clocks, counted from the store that sets all the pins high: the zeros go low at T0H, the ones at T1H,
+ * and the next bit starts at TBIT. These are the same points the per-speed routines in tinyNeoPixel.cpp use (at 16 MHz
+ * they come out to exactly the 5, 13 and 20 used there) - but here there is only one loop, so the delays between the
+ * stores are worked out from F_CPU and padded with nops instead of being hand-tuned for each speed range. The low part
+ * of the bit has to fit the load of the next slice and the loop, 7 clocks in all, so below 16 MHz the bits get longer
+ * than 1.25 us - only the low part stretches, which the LEDs don't mind.
+ *   T0H  = 0.3 us rounded up
+ *   T1H  = 0.8 us rounded to nearest
+ *   TBIT = 1.25 us rounded to nearest, or T1H + 7 if that's more
+ */
+#define _PAR_T0H    ((F_CPU / 100000UL * 3 + 99) / 100)
+#define _PAR_T1H    ((F_CPU / 100000UL * 8 + 50) / 100)
+#define _PAR_TBIT_  ((F_CPU / 100000UL * 125 + 500) / 1000)
+#define _PAR_TBIT   ((_PAR_TBIT_ > _PAR_T1H + 7) ? _PAR_TBIT_ : _PAR_T1H + 7)
+
+#if (_PAR_T0H < 2) || (_PAR_T1H <= _PAR_T0H)
+  #error "CPU SPEED NOT SUPPORTED"
+#endif
+
+// *INDENT-OFF*   astyle don't like assembly
+void tinyNeoPixel_Parallel::show(void) {
+  if (!strips) {
+    return;
+  }
+  uint16_t count = numBytes * 8;
+  const uint8_t *ptr = slices;
+  volatile uint8_t *out = &((VPORT_t *)&VPORTA)[port].OUT;
+  uint8_t hi, lo, next;
+
+  while (!canShow());
+  noInterrupts();
+  hi = *out |  portMask;
+  lo = *out & ~portMask;
+
+  asm volatile(
+      "ld   %[next] , %a[ptr]+"   "\n\t" // 2    first slice
+    "_headpar%=:"                 "\n\t" //                    (T = 0)
+      "st   %a[out] , %[hi]"      "\n\t" // 1    all high
+      "or   %[next] , %[lo]"      "\n\t" // 1    the pins of the port that aren't ours stay as they were
+      ".rept %[d0]"               "\n\t"
+      "nop"                       "\n\t"
+      ".endr"                     "\n\t"
+      "st   %a[out] , %[next]"    "\n\t" // 1    zeros low     (T = T0H)
+      ".rept %[d1]"               "\n\t"
+      "nop"                       "\n\t"
+      ".endr"                     "\n\t"
+      "st   %a[out] , %[lo]"      "\n\t" // 1    all low       (T = T1H)
+      "ld   %[next] , %a[ptr]+"   "\n\t" // 2    next slice (one past the end, the last time around - not used)
+      "sbiw %[count], 1"          "\n\t" // 2
+      ".rept %[d2]"               "\n\t"
+      "nop"                       "\n\t"
+      ".endr"                     "\n\t"
+      "brne _headpar%="           "\n"   // 2    (T = TBIT)
+    : [ptr]   "+e" (ptr),
+      [next]  "=&r" (next),
+      [count] "+w" (count)
+    : [out]   "e" (out),
+      [hi]    "r" (hi),
+      [lo]    "r" (lo),
+      [d0]    "n" (_PAR_T0H - 2),
+      [d1]    "n" (_PAR_T1H - _PAR_T0H - 1),
+      [d2]    "n" (_PAR_TBIT - _PAR_T1H - 7));
+
+  interrupts();
+  #if (!defined(MILLIS_USE_TIMERNONE) && !defined(MILLIS_USE_TIMERRTC) && !defined(MILLIS_USE_TIMERRTC_XTAL) && !defined(MILLIS_USE_TIMERRTC_XOSC))
+    endTime = micros();
+  #endif
+}
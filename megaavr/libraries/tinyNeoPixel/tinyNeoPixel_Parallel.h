@@ -0,0 +1,84 @@
+/*--------------------------------------------------------------------
+  This file is part of the tinyNeoPixel library, derived from
+  Adafruit_NeoPixel.
+
+  NeoPixel is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, either version 3 of
+  the License, or (at your option) any later version.
+
+  NeoPixel is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with NeoPixel.  If not, see
+  <http://www.gnu.org/licenses/>.
+  --------------------------------------------------------------------*/
+
+/* tinyNeoPixel_Parallel - up to 8 strips, all on the same port, sent at the same time, so a frame takes as long as it
+ * does for one strip instead of for all of them one after the other.
+ *
+ * The pixels are stored "bit-sliced": for every bit sent, one byte holds that bit for every strip, in the bit position
+ * of that strip's pin. show() then only has to write the port three times per bit - all high, then the byte (the ones
+ * stay high, the zeros go low), then all low - whatever the number of strips. The buffer is 8 bytes for every byte of a
+ * strip, no matter how many strips there are, so with 8 strips it's the same size as 8 separate ones would be.
+ * Setting or getting a pixel has to scatter or gather the bits, so it's slower than on a tinyNeoPixel.
+ *
+ * All strips are the same length and type. Interrupts are disabled during show(), like tinyNeoPixel, for as long as it
+ * takes to send one strip.
+ */
+
+#ifndef TINYNEOPIXEL_PARALLEL_H
+#define TINYNEOPIXEL_PARALLEL_H
+#include "tinyNeoPixel.h"
+
+class tinyNeoPixel_Parallel {
+  public:
+    // n LEDs on each of numStrips strips, on the pins listed in pins[], which must all be on the same port.
+    tinyNeoPixel_Parallel(uint16_t n, const uint8_t *pins, uint8_t numStrips, neoPixelType t = NEO_GRB);
+    ~tinyNeoPixel_Parallel();
+
+  bool
+    begin(void);   // false if the pins weren't usable or there wasn't enough memory for the pixels
+  void
+    show(void),
+    setPixelColor(uint8_t strip, uint16_t n, uint8_t r, uint8_t g, uint8_t b),
+    setPixelColor(uint8_t strip, uint16_t n, uint8_t r, uint8_t g, uint8_t b, uint8_t w),
+    setPixelColor(uint8_t strip, uint16_t n, uint32_t c),
+    clear(void),
+    updateLatch(uint16_t us = 50);
+  uint32_t
+    getPixelColor(uint8_t strip, uint16_t n) const;
+  uint16_t
+    numPixels(void) const { return numLEDs; }
+  uint8_t
+    numStrips(void) const { return strips; }
+
+  #if (!defined(MILLIS_USE_TIMERNONE) && !defined(MILLIS_USE_TIMERRTC) && !defined(MILLIS_USE_TIMERRTC_XTAL) && !defined(MILLIS_USE_TIMERRTC_XOSC))
+    inline bool canShow(void) { return (micros() - endTime) >= (uint32_t) latchTime; }
+  #else
+    inline bool canShow(void) {return 1;} // we don't have micros here;
+  #endif
+
+ private:
+  uint16_t
+    numLEDs,       // Number of LEDs on each strip
+    numBytes,      // Bytes per strip (3 or 4 per pixel); the buffer is 8 times that
+    latchTime;
+  uint8_t
+    strips,        // 0 if the pins weren't all on one port
+    port,          // Port number (0 = PORTA)
+    portMask,      // All the pins
+    stripMask[8],  // The pin of each strip
+   *slices,        // One byte per bit sent, one bit per strip
+    rOffset,
+    gOffset,
+    bOffset,
+    wOffset;
+  uint32_t
+    endTime;
+};
+
+#endif
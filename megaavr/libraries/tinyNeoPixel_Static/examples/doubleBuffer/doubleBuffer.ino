@@ -0,0 +1,37 @@
+// tinyNeoPixel_HW with double buffering - while one frame goes out in the background, the next one is worked out in
+// the pixel array, and the brightness breathes up and down without losing any color resolution, since it's applied to
+// the copy that gets sent rather than to the pixels. Dx-series only; see the tinyNeoPixel documentation for what it
+// uses. The LEDs have to be on a LUT output pin.
+
+#include <tinyNeoPixel_Static_HW.h>
+
+#define PIN       PIN_PA3 // LUT0 output
+#define NUMPIXELS 150
+
+byte pixels[NUMPIXELS * 3];
+byte front[NUMPIXELS * 3]; // what's being sent
+
+tinyNeoPixel_HW strip = tinyNeoPixel_HW(NUMPIXELS, PIN, NEO_GRB, pixels);
+
+uint16_t firstHue = 0;
+uint8_t level = 0;
+
+void setup() {
+  Serial.begin(115200);
+  strip.useDoubleBuffer(front);
+  strip.setGamma(true);
+  if (!strip.begin()) {
+    Serial.println("Hardware output isn't available on that pin, or something it needs is in use");
+    while (1);
+  }
+}
+
+void loop() {
+  // The last frame may well still be going out - that's fine, it was copied.
+  for (uint16_t i = 0; i < NUMPIXELS; i++) {
+    strip.setPixelColor(i, strip.ColorHSV(firstHue + (i * 65536UL / NUMPIXELS)));
+  }
+  strip.setBrightness(strip.sine8(level++));
+  strip.show(); // waits for the last frame to finish, copies this one, and returns.
+  firstHue += 256;
+}
@@ -305,7 +305,7 @@ class tinyNeoPixel {
   #endif
 
 
- private:
+ protected: // tinyNeoPixel_Static_HW.h builds on these
 
   uint16_t
     numLEDs,       // Number of RGB LEDs in strip
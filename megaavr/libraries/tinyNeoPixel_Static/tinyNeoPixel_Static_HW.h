@@ -0,0 +1,48 @@
+/*--------------------------------------------------------------------
+  This file is part of the tinyNeoPixel library, derived from
+  Adafruit_NeoPixel.
+
+  NeoPixel is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, either version 3 of
+  the License, or (at your option) any later version.
+
+  NeoPixel is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with NeoPixel.  If not, see
+  <http://www.gnu.org/licenses/>.
+  --------------------------------------------------------------------*/
+
+/* tinyNeoPixel_HW for tinyNeoPixel_Static - the same thing as tinyNeoPixel_Static, except that show() has the hardware
+ * make the waveform, and returns as soon as the data is on its way instead of turning off interrupts until the last bit
+ * is out. How it works, what it uses and which pins it can use are in tinyNeoPixel_HWBase.h in the tinyNeoPixel
+ * library; all that's here is the front buffer, which this version is handed, like the pixels.
+ */
+
+#ifndef TINYNEOPIXEL_STATIC_HW_H
+#define TINYNEOPIXEL_STATIC_HW_H
+#include "tinyNeoPixel_Static.h"
+// By path rather than as <tinyNeoPixel_HWBase.h>, which would make the IDE build the tinyNeoPixel library as well, and
+// its tinyNeoPixel class would collide with this one.
+#include "../tinyNeoPixel/tinyNeoPixel_HWBase.h"
+
+class tinyNeoPixel_HW : public tinyNeoPixel_HWBase<tinyNeoPixel> {
+  public:
+    tinyNeoPixel_HW(uint16_t n, uint8_t p, neoPixelType t, uint8_t *pxl) : tinyNeoPixel_HWBase(n, p, t, pxl) {}
+
+    /* Send a copy of the pixels instead of the pixels themselves - see show(). front is an array the same size as the
+     * one passed to the constructor. From then on, setBrightness() is applied to the copy as it's made, instead of to
+     * the pixels when they're set, so changing it loses nothing, and setGamma(true) can do the same with gamma8(). If
+     * the brightness was set before this, the pixels already set were scaled by it, and will be scaled again on the way
+     * out, so do this first. */
+    void useDoubleBuffer(uint8_t *front) {
+      flush();
+      _useFront(front);
+    }
+};
+
+#endif
@@ -447,7 +447,39 @@ const uint8_t digital_pin_to_timer[] = {
   NOT_ON_TIMER  //  21 PF7 UPDI
 };
 
-
+/* Generated by extras/development/make_pin_descriptors.py from the tables above - rerun it after changing them. */
+const pin_descriptor_t digital_pin_to_descriptor[] = {
+  #if CLOCK_SOURCE == 0
+    _PIN_DESC(PA, PIN0_bp, NOT_ON_TIMER), //  0 PA0/USART0_Tx/CLKIN
+  #else
+    _PIN_DESC_NONE,
+  #endif
+  #if CLOCK_SOURCE == 1
+    _PIN_DESC_NONE,                       //  1 PA1/USART0_Rx
+  #else
+    _PIN_DESC(PA, PIN1_bp, NOT_ON_TIMER),
+  #endif
+  _PIN_DESC_NONE,                         //  2 NOT_A_PIN
+  _PIN_DESC_NONE,                         //  3 NOT_A_PIN
+  _PIN_DESC_NONE,                         //  4 NOT_A_PIN
+  _PIN_DESC_NONE,                         //  5 NOT_A_PIN
+  _PIN_DESC_NONE,                         //  6 NOT_A_PIN
+  _PIN_DESC_NONE,                         //  7 NOT_A_PIN
+  _PIN_DESC_NONE,                         //  8 PC0 Phantom pin
+  _PIN_DESC(PC, PIN1_bp, NOT_ON_TIMER),   //  9 PC1/USART1_Rx/TCA0 PWM
+  _PIN_DESC(PC, PIN2_bp, NOT_ON_TIMER),   // 10 PC2/TCA0 PWM
+  _PIN_DESC(PC, PIN3_bp, NOT_ON_TIMER),   // 11 PC3/TCA0 PWM
+  _PIN_DESC_NONE,                         // 12 PD0 Phantom pin
+  _PIN_DESC_NONE,                         // 13 NOT_A_PIN
+  _PIN_DESC_NONE,                         // 14 NOT_A_PIN
+  _PIN_DESC_NONE,                         // 15 NOT_A_PIN
+  _PIN_DESC(PD, PIN4_bp, TIMERD0_4WOC),   // 16 PD4/AIN4
+  _PIN_DESC(PD, PIN5_bp, TIMERD0_4WOD),   // 17 PD5/AIN5
+  _PIN_DESC(PD, PIN6_bp, DACOUT),         // 18 PD6/AIN6
+  _PIN_DESC(PD, PIN7_bp, NOT_ON_TIMER),   // 19 PD7/AIN7/AREF
+  _PIN_DESC(PF, PIN6_bp, NOT_ON_TIMER),   // 20 PF6 RESET
+  _PIN_DESC(PF, PIN7_bp, NOT_ON_TIMER)    // 21 PF7 UPDI
+};
 #endif
   // These are used for CI testing. They should *not* *ever* be used except for CI-testing where we need to pick a viable pin to compile for
   #if CLOCK_SOURCE != 0
@@ -420,6 +420,35 @@ const uint8_t digital_pin_to_timer[] = { // *INDENT-OFF*
   NOT_ON_TIMER, // 21 PF7 UPDI
 };
 
+/* Generated by extras/development/make_pin_descriptors.py from the tables above - rerun it after changing them. */
+const pin_descriptor_t digital_pin_to_descriptor[] = {
+  #if CLOCK_SOURCE == 0
+    _PIN_DESC(PA, PIN0_bp, TIMERF0_0WO0), //  0 PA0/USART0_Tx/CLKIN
+  #else
+    _PIN_DESC_NONE,
+  #endif
+  _PIN_DESC(PA, PIN1_bp, TIMERF0_0WO1),   //  1 PA1/USART0_Rx
+  _PIN_DESC(PA, PIN2_bp, TIMERB0),        //  2 PA2/SDA
+  _PIN_DESC(PA, PIN3_bp, TIMERB1),        //  3 PA3/SCL
+  _PIN_DESC(PA, PIN4_bp, NOT_ON_TIMER),   //  4 PA4/MOSI
+  _PIN_DESC(PA, PIN5_bp, NOT_ON_TIMER),   //  5 PA5/MISO
+  _PIN_DESC(PA, PIN6_bp, TIMERF0_1WO0),   //  6 PA6/SCK
+  _PIN_DESC(PA, PIN7_bp, TIMERF0_1WO1),   //  7 PA7/SS/CLKOUT/LED_BUILTIN
+  _PIN_DESC(PC, PIN0_bp, NOT_ON_TIMER),   //  8 PC0
+  _PIN_DESC(PC, PIN1_bp, NOT_ON_TIMER),   //  9 PC1
+  _PIN_DESC(PC, PIN2_bp, NOT_ON_TIMER),   // 10 PC2
+  _PIN_DESC(PC, PIN3_bp, NOT_ON_TIMER),   // 11 PC3M
+  _PIN_DESC_NONE,                         // 12 We give PD0 a number and specify it as being on PORTD because things depend on that because it is the zero pin and the origin of the analog inputs.
+  _PIN_DESC_NONE,                         // 13 No PD1
+  _PIN_DESC_NONE,                         // 14 No PD2
+  _PIN_DESC_NONE,                         // 15 No PD3
+  _PIN_DESC(PD, PIN4_bp, NOT_ON_TIMER),   // 16 PD4/AIN4
+  _PIN_DESC(PD, PIN5_bp, NOT_ON_TIMER),   // 17 PD5/AIN5
+  _PIN_DESC(PD, PIN6_bp, NOT_ON_TIMER),   // 18 PD6/AIN6
+  _PIN_DESC(PD, PIN7_bp, NOT_ON_TIMER),   // 19 PD7/AIN7/AREF
+  _PIN_DESC(PF, PIN6_bp, NOT_ON_TIMER),   // 20 PF6 RESET
+  _PIN_DESC(PF, PIN7_bp, NOT_ON_TIMER)    // 21 PF7 UPDI
+};
 #endif
   // These are used for CI testing. They should *not* *ever* be used except for CI-testing where we need to pick a viable pin to compile a sketch with that won't generate compile errors (we don't care whether it would;d actually work, we are concerned with )
   #if CLOCK_SOURCE != 0
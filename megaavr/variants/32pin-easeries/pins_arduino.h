@@ -492,5 +492,40 @@ const uint8_t digital_pin_to_timer[] = {
   NOT_ON_TIMER  // 27 PF7 UPDI
 };
 
+/* Generated by extras/development/make_pin_descriptors.py from the tables above - rerun it after changing them. */
+const pin_descriptor_t digital_pin_to_descriptor[] = {
+  #if CLOCK_SOURCE == 0
+    _PIN_DESC(PA, PIN0_bp, NOT_ON_TIMER), //  0 PA0/USART0_Tx/CLKIN
+  #else
+    _PIN_DESC_NONE,
+  #endif
+  _PIN_DESC(PA, PIN1_bp, NOT_ON_TIMER),   //  1 PA1/USART0_Rx
+  _PIN_DESC(PA, PIN2_bp, TIMERB0),        //  2 PA2/AIN22/SDA
+  _PIN_DESC(PA, PIN3_bp, TIMERB1),        //  3 PA3/AIN23/SCL
+  _PIN_DESC(PA, PIN4_bp, NOT_ON_TIMER),   //  4 PA4/AIN24/MOSI
+  _PIN_DESC(PA, PIN5_bp, NOT_ON_TIMER),   //  5 PA5/AIN25/MISO
+  _PIN_DESC(PA, PIN6_bp, NOT_ON_TIMER),   //  6 PA6/AIN26/SCK
+  _PIN_DESC(PA, PIN7_bp, NOT_ON_TIMER),   //  7 PA7/AIN27/SS/CLKOUT/LED_BUILTIN
+  _PIN_DESC(PC, PIN0_bp, TIMERB2),        //  8 PC0/AIN28
+  _PIN_DESC(PC, PIN1_bp, TIMERB3),        //  9 PC1/AIN29
+  _PIN_DESC(PC, PIN2_bp, NOT_ON_TIMER),   // 10 PC2/AIN30
+  _PIN_DESC(PC, PIN3_bp, NOT_ON_TIMER),   // 11 PC3/AIN31
+  _PIN_DESC(PD, PIN0_bp, NOT_ON_TIMER),   // 12 PD0/AIN0
+  _PIN_DESC(PD, PIN1_bp, NOT_ON_TIMER),   // 13 PD1/AIN1
+  _PIN_DESC(PD, PIN2_bp, NOT_ON_TIMER),   // 14 PD2/AIN2
+  _PIN_DESC(PD, PIN3_bp, NOT_ON_TIMER),   // 15 PD3/AIN3
+  _PIN_DESC(PD, PIN4_bp, NOT_ON_TIMER),   // 16 PD4/AIN4
+  _PIN_DESC(PD, PIN5_bp, NOT_ON_TIMER),   // 17 PD5/AIN5
+  _PIN_DESC(PD, PIN6_bp, DACOUT),         // 18 PD6/AIN6
+  _PIN_DESC(PD, PIN7_bp, NOT_ON_TIMER),   // 19 PD7/AIN7/AREF
+  _PIN_DESC(PF, PIN0_bp, NOT_ON_TIMER),   // 20 PF0/AIN16
+  _PIN_DESC(PF, PIN1_bp, NOT_ON_TIMER),   // 21 PF1/AIN17
+  _PIN_DESC(PF, PIN2_bp, NOT_ON_TIMER),   // 22 PF2/AIN18
+  _PIN_DESC(PF, PIN3_bp, NOT_ON_TIMER),   // 23 PF3/AIN19
+  _PIN_DESC(PF, PIN4_bp, NOT_ON_TIMER),   // 24 PF4/AIN20
+  _PIN_DESC(PF, PIN5_bp, NOT_ON_TIMER),   // 25 PF5/AIN21
+  _PIN_DESC(PF, PIN6_bp, NOT_ON_TIMER),   // 26 PF6 RESET
+  _PIN_DESC(PF, PIN7_bp, NOT_ON_TIMER)    // 27 PF7 UPDI
+};
 #endif
 #endif
@@ -649,6 +649,73 @@ const uint8_t digital_pin_to_timer[] = {
   NOT_ON_TIMER, //  54 PF6 (RESET)
   //NOT_ON_TIMER, //55 PF7 (UPDI)
 };
+
+/* Generated by extras/development/make_pin_descriptors.py from the tables above - rerun it after changing them. */
+const pin_descriptor_t digital_pin_to_descriptor[] = {
+  #if CLOCK_SOURCE == 0
+    _PIN_DESC(PA, PIN0_bp, NOT_ON_TIMER), //  0 PA0/XTAL0/CLKIN   (Note that it's not a pin when using external clock, and bitmask and position will come back as NOT_A_PIN)
+  #else
+    _PIN_DESC_NONE,
+  #endif
+  #if CLOCK_SOURCE == 1
+    _PIN_DESC_NONE,                       //  1 PA1/XTAL1 (If using a crystal, same as above.)
+  #else
+    _PIN_DESC(PA, PIN1_bp, NOT_ON_TIMER),
+  #endif
+  _PIN_DESC(PA, PIN2_bp, NOT_ON_TIMER),   //  2 PA2
+  _PIN_DESC(PA, PIN3_bp, NOT_ON_TIMER),   //  3 PA3
+  _PIN_DESC(PA, PIN4_bp, TIMERD0_0WOA),   //  4 PA4
+  _PIN_DESC(PA, PIN5_bp, TIMERD0_0WOB),   //  5 PA5
+  _PIN_DESC(PA, PIN6_bp, TIMERD0_0WOC),   //  6 PA6
+  _PIN_DESC(PA, PIN7_bp, TIMERD0_0WOD),   //  7 PA7
+  _PIN_DESC(PB, PIN0_bp, NOT_ON_TIMER),   //  8 PB0
+  _PIN_DESC(PB, PIN1_bp, NOT_ON_TIMER),   //  9 PB1
+  _PIN_DESC(PB, PIN2_bp, NOT_ON_TIMER),   // 10 PB2
+  _PIN_DESC(PB, PIN3_bp, NOT_ON_TIMER),   // 11 PB3
+  _PIN_DESC(PB, PIN4_bp, NOT_ON_TIMER),   // 12 PB4
+  _PIN_DESC(PB, PIN5_bp, NOT_ON_TIMER),   // 13 PB5
+  _PIN_DESC(PB, PIN6_bp, NOT_ON_TIMER),   // 14 PB6
+  _PIN_DESC(PB, PIN7_bp, NOT_ON_TIMER),   // 15 PB7
+  _PIN_DESC(PC, PIN0_bp, TIMERB2),        // 16 PC0
+  _PIN_DESC(PC, PIN1_bp, TIMERB3),        // 17 PC1
+  _PIN_DESC(PC, PIN2_bp, NOT_ON_TIMER),   // 18 PC2
+  _PIN_DESC(PC, PIN3_bp, NOT_ON_TIMER),   // 19 PC3
+  _PIN_DESC(PC, PIN4_bp, NOT_ON_TIMER),   // 20 PC4
+  _PIN_DESC(PC, PIN5_bp, NOT_ON_TIMER),   // 21 PC5
+  _PIN_DESC(PC, PIN6_bp, NOT_ON_TIMER),   // 22 PC6
+  _PIN_DESC(PC, PIN7_bp, NOT_ON_TIMER),   // 23 PC7
+  _PIN_DESC(PD, PIN0_bp, NOT_ON_TIMER),   // 24 PD0
+  _PIN_DESC(PD, PIN1_bp, NOT_ON_TIMER),   // 25 PD1
+  _PIN_DESC(PD, PIN2_bp, NOT_ON_TIMER),   // 26 PD2
+  _PIN_DESC(PD, PIN3_bp, NOT_ON_TIMER),   // 27 PD3
+  _PIN_DESC(PD, PIN4_bp, NOT_ON_TIMER),   // 28 PD4
+  _PIN_DESC(PD, PIN5_bp, NOT_ON_TIMER),   // 29 PD5
+  _PIN_DESC(PD, PIN6_bp, DACOUT),         // 30 PD6
+  _PIN_DESC(PD, PIN7_bp, NOT_ON_TIMER),   // 31 PD7
+  _PIN_DESC(PE, PIN0_bp, NOT_ON_TIMER),   // 32 PE0
+  _PIN_DESC(PE, PIN1_bp, NOT_ON_TIMER),   // 33 PE1
+  _PIN_DESC(PE, PIN2_bp, NOT_ON_TIMER),   // 34 PE2
+  _PIN_DESC(PE, PIN3_bp, NOT_ON_TIMER),   // 35 PE3
+  _PIN_DESC(PE, PIN4_bp, NOT_ON_TIMER),   // 36 PE4
+  _PIN_DESC(PE, PIN5_bp, NOT_ON_TIMER),   // 37 PE5
+  _PIN_DESC(PE, PIN6_bp, NOT_ON_TIMER),   // 38 PE6
+  _PIN_DESC(PE, PIN7_bp, NOT_ON_TIMER),   // 39 PE7
+  _PIN_DESC(PF, PIN0_bp, NOT_ON_TIMER),   // 40 PF0
+  _PIN_DESC(PF, PIN1_bp, NOT_ON_TIMER),   // 41 PF1
+  _PIN_DESC(PF, PIN2_bp, NOT_ON_TIMER),   // 42 PF2
+  _PIN_DESC(PF, PIN3_bp, NOT_ON_TIMER),   // 43 PF3
+  _PIN_DESC(PF, PIN4_bp, TIMERB0),        // 44 PF4
+  _PIN_DESC(PF, PIN5_bp, TIMERB1),        // 45 PF5
+  _PIN_DESC(PG, PIN0_bp, NOT_ON_TIMER),   // 46 PG0
+  _PIN_DESC(PG, PIN1_bp, NOT_ON_TIMER),   // 47 PG1
+  _PIN_DESC(PG, PIN2_bp, NOT_ON_TIMER),   // 48 PG2
+  _PIN_DESC(PG, PIN3_bp, TIMERB4),        // 49 PG3
+  _PIN_DESC(PG, PIN4_bp, NOT_ON_TIMER),   // 50 PG4
+  _PIN_DESC(PG, PIN5_bp, NOT_ON_TIMER),   // 51 PG5
+  _PIN_DESC(PG, PIN6_bp, NOT_ON_TIMER),   // 52 PG6
+  _PIN_DESC(PG, PIN7_bp, NOT_ON_TIMER),   // 53 PG7
+  _PIN_DESC(PF, PIN6_bp, NOT_ON_TIMER)    // 54 PF6
+};
 #endif
   // These are used for CI testing. They should *not* *ever* be used except for CI-testing where we need to pick a viable pin to compile a sketch with that won't generate compile errors (we don't care whether it would;d actually work, we are concerned with )
   #if CLOCK_SOURCE != 0